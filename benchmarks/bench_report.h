@@ -0,0 +1,115 @@
+#pragma once
+
+#include "utils/frame_pacer.h"
+
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/// One benchmark case: frame-time percentiles plus throughput rates.
+struct Result
+{
+    std::string name;
+    std::string kind;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t threads = 0;
+    sc::utils::FrameStats::Summary frame;
+    /// Throughput over the measured frames; 0 where it does not apply.
+    double trianglesPerS = 0.0;
+    double fragmentsPerS = 0.0;
+    double raysPerS = 0.0;
+};
+
+inline void writeText(std::ostream& os, const Result& r)
+{
+    os << std::left << std::setw(22) << r.name << std::right
+       << std::fixed << std::setprecision(3)
+       << " mean " << std::setw(9) << r.frame.meanMs
+       << " p50 " << std::setw(9) << r.frame.p50Ms
+       << " p95 " << std::setw(9) << r.frame.p95Ms
+       << " p99 " << std::setw(9) << r.frame.p99Ms
+       << " max " << std::setw(9) << r.frame.maxMs << " ms";
+    os << std::scientific << std::setprecision(3);
+    if (r.trianglesPerS > 0.0)
+        os << "  tris/s " << r.trianglesPerS;
+    if (r.fragmentsPerS > 0.0)
+        os << "  frags/s " << r.fragmentsPerS;
+    if (r.raysPerS > 0.0)
+        os << "  rays/s " << r.raysPerS;
+    os << std::defaultfloat << '\n';
+}
+
+inline void writeJson(std::ostream& os, const std::vector<Result>& results)
+{
+    os << std::setprecision(9) << "{\"results\":[";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        os << (i ? ",\n" : "\n")
+           << "{\"name\":\"" << r.name << "\",\"kind\":\"" << r.kind << '"'
+           << ",\"width\":" << r.width << ",\"height\":" << r.height
+           << ",\"threads\":" << r.threads
+           << ",\"frames\":" << r.frame.frames
+           << ",\"ms_mean\":" << r.frame.meanMs
+           << ",\"ms_p50\":" << r.frame.p50Ms
+           << ",\"ms_p95\":" << r.frame.p95Ms
+           << ",\"ms_p99\":" << r.frame.p99Ms
+           << ",\"ms_max\":" << r.frame.maxMs
+           << ",\"triangles_per_s\":" << r.trianglesPerS
+           << ",\"fragments_per_s\":" << r.fragmentsPerS
+           << ",\"rays_per_s\":" << r.raysPerS
+           << '}';
+    }
+    os << "\n]}\n";
+}
+
+inline void writeCsv(std::ostream& os, const std::vector<Result>& results)
+{
+    os << std::setprecision(9)
+       << "name,kind,width,height,threads,frames,ms_mean,ms_p50,ms_p95,ms_p99,ms_max,"
+          "triangles_per_s,fragments_per_s,rays_per_s\n";
+    for (const auto& r : results)
+    {
+        os << r.name << ',' << r.kind << ',' << r.width << ',' << r.height << ','
+           << r.threads << ',' << r.frame.frames << ',' << r.frame.meanMs << ','
+           << r.frame.p50Ms << ',' << r.frame.p95Ms << ',' << r.frame.p99Ms << ','
+           << r.frame.maxMs << ',' << r.trianglesPerS << ',' << r.fragmentsPerS << ','
+           << r.raysPerS << '\n';
+    }
+}
+
+/// Writes to @p path, or to stdout when it is "-". Returns false when the
+/// report could not be written.
+template<typename Results, typename Writer>
+bool writeReport(const std::string& path, const Results& results, Writer write)
+{
+    if (path == "-")
+    {
+        write(std::cout, results);
+        return static_cast<bool>(std::cout);
+    }
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "cannot open " << path << '\n';
+        return false;
+    }
+    write(file, results);
+    file.flush();
+    if (!file)
+    {
+        std::cerr << "cannot write " << path << '\n';
+        return false;
+    }
+    return true;
+}
+
+} // namespace bench
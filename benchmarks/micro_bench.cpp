@@ -0,0 +1,426 @@
+#include "bench_report.h"
+#include "black_hole_scene.h"
+#include "main_pipeline.h"
+#include "micro_bench.h"
+#include "model/io.h"
+#include "model/texture.h"
+#include "ray_marching_iterator.h"
+#include "utils/mat.h"
+#include "utils/tiled_rasterizer.h"
+#include "utils/vec.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Isolated timings of the kernels behind a frame. Every case runs on
+// inputs generated from a fixed seed, so runs are comparable.
+//
+//   micro_bench [--filter TEXT] [--warmup N] [--reps N] [--min-batch-ms MS]
+//               [--counters] [--obj FILE] [--json FILE|-] [--csv FILE|-]
+
+namespace
+{
+
+using fpT = float;
+using Vec2 = sc::utils::Vec<fpT, 2>;
+using Vec3 = sc::utils::Vec<fpT, 3>;
+using Vec4 = sc::utils::Vec<fpT, 4>;
+using Mat4 = sc::utils::Mat<fpT, 4, 4>;
+
+/// Elements per operation of the array kernels.
+constexpr std::size_t arraySize = 1024;
+
+struct Options
+{
+    bench::MicroParams params;
+    std::string filter;
+    std::string obj;
+    std::string json;
+    std::string csv;
+};
+
+std::vector<Vec3> randomVectors(std::size_t count, fpT lo, fpT hi, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<fpT> dist(lo, hi);
+    std::vector<Vec3> out(count);
+    for (auto& v : out)
+        v = Vec3{dist(rng), dist(rng), dist(rng)};
+    return out;
+}
+
+Mat4 randomMatrix(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<fpT> dist(-1.f, 1.f);
+    Mat4 m;
+    for (std::size_t r = 0; r < 4; ++r)
+        for (std::size_t c = 0; c < 4; ++c)
+            m(r, c) = dist(rng);
+    return m;
+}
+
+/// Writes a UV sphere of about @p faces triangles as OBJ with positions,
+/// texture coordinates and normals, standing in for a large scanned mesh.
+std::string writeLargeObj(std::size_t faces)
+{
+    const auto rings = static_cast<std::size_t>(std::sqrt(static_cast<double>(faces) / 2.0));
+    const std::size_t segments = rings;
+    const auto path = std::filesystem::temp_directory_path() / "micro_bench_sphere.obj";
+
+    std::ofstream file(path);
+    for (std::size_t r = 0; r <= rings; ++r)
+    {
+        const double theta = M_PI * static_cast<double>(r) / static_cast<double>(rings);
+        for (std::size_t s = 0; s <= segments; ++s)
+        {
+            const double phi = 2.0 * M_PI * static_cast<double>(s) / static_cast<double>(segments);
+            const double x = std::sin(theta) * std::cos(phi);
+            const double y = std::cos(theta);
+            const double z = std::sin(theta) * std::sin(phi);
+            file << "v " << x << ' ' << y << ' ' << z << '\n'
+                 << "vt " << static_cast<double>(s) / static_cast<double>(segments) << ' '
+                 << static_cast<double>(r) / static_cast<double>(rings) << '\n'
+                 << "vn " << x << ' ' << y << ' ' << z << '\n';
+        }
+    }
+    for (std::size_t r = 0; r < rings; ++r)
+    {
+        for (std::size_t s = 0; s < segments; ++s)
+        {
+            const std::size_t a = r * (segments + 1) + s + 1;
+            const std::size_t b = a + segments + 1;
+            file << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' '
+                 << a + 1 << '/' << a + 1 << '/' << a + 1 << '\n'
+                 << "f " << b << '/' << b << '/' << b << ' ' << b + 1 << '/' << b + 1 << '/' << b + 1 << ' '
+                 << a + 1 << '/' << a + 1 << '/' << a + 1 << '\n';
+        }
+    }
+    return path.string();
+}
+
+/// Screen-space triangle with edges of about @p size pixels centred at
+/// (cx, cy), at depth 1.
+std::array<mrc::internal::ProjectedVertex<fpT>, 3> makeTriangle(fpT cx, fpT cy, fpT size)
+{
+    std::array<mrc::internal::ProjectedVertex<fpT>, 3> tri{ };
+    const std::array<Vec2, 3> corners = {
+        Vec2{cx - size * .5f, cy + size * .43f},
+        Vec2{cx + size * .5f, cy + size * .43f},
+        Vec2{cx, cy - size * .43f},
+    };
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        tri[i].pixel = corners[i];
+        tri[i].invW = 1.f;
+        tri[i].depth = 1.f;
+        tri[i].attr.normal = Vec3{0.f, 0.f, 1.f};
+        tri[i].attr.uv = Vec2{corners[i][0] / 512.f, corners[i][1] / 512.f};
+    }
+    return tri;
+}
+
+class Suite
+{
+public:
+    explicit Suite(const Options& options) : _options(options) {}
+
+    template<typename Operation>
+    void run(const std::string& name, Operation&& op, std::size_t itemsPerOp = 1)
+    {
+        if (!_options.filter.empty() && name.find(_options.filter) == std::string::npos)
+            return;
+        _results.push_back(bench::runMicro(name, _options.params, op, itemsPerOp));
+        bench::writeText(std::cout, _results.back());
+    }
+
+    [[nodiscard]] const std::vector<bench::MicroResult>& results() const { return _results; }
+
+private:
+    const Options& _options;
+    std::vector<bench::MicroResult> _results;
+};
+
+void vecMatCases(Suite& suite)
+{
+    const auto a = randomVectors(arraySize, -1.f, 1.f, 1);
+    const auto b = randomVectors(arraySize, -1.f, 1.f, 2);
+    std::vector<Vec3> out(arraySize);
+
+    suite.run("vec3/add_mul", [&]() {
+        for (std::size_t i = 0; i < arraySize; ++i)
+            out[i] = a[i] + b[i] * 0.5f;
+        bench::doNotOptimize(out);
+    }, arraySize);
+
+    suite.run("vec3/dot", [&]() {
+        fpT sum = 0;
+        for (std::size_t i = 0; i < arraySize; ++i)
+            sum += sc::utils::dot(a[i], b[i]);
+        bench::doNotOptimize(sum);
+    }, arraySize);
+
+    suite.run("vec3/cross", [&]() {
+        for (std::size_t i = 0; i < arraySize; ++i)
+            out[i] = sc::utils::cross(a[i], b[i]);
+        bench::doNotOptimize(out);
+    }, arraySize);
+
+    suite.run("vec3/norm", [&]() {
+        for (std::size_t i = 0; i < arraySize; ++i)
+            out[i] = sc::utils::norm(a[i]);
+        bench::doNotOptimize(out);
+    }, arraySize);
+
+    suite.run("vec3/rotateEuler", [&]() {
+        for (std::size_t i = 0; i < arraySize; ++i)
+            out[i] = sc::utils::rotateEuler(a[i], b[i]);
+        bench::doNotOptimize(out);
+    }, arraySize);
+
+    const Mat4 m = randomMatrix(3);
+    const Mat4 n = randomMatrix(4);
+    std::vector<Vec4> points(arraySize);
+    for (std::size_t i = 0; i < arraySize; ++i)
+        points[i] = Vec4{a[i][0], a[i][1], a[i][2], 1.f};
+    std::vector<Vec4> transformed(arraySize);
+
+    suite.run("mat4/mul_vec4", [&]() {
+        for (std::size_t i = 0; i < arraySize; ++i)
+            transformed[i] = m * points[i];
+        bench::doNotOptimize(transformed);
+    }, arraySize);
+
+    suite.run("mat4/mul_mat4", [&]() {
+        Mat4 acc = m;
+        for (std::size_t i = 0; i < 64; ++i)
+            acc = acc * n;
+        bench::doNotOptimize(acc);
+    }, 64);
+}
+
+void textureCases(Suite& suite)
+{
+    constexpr std::size_t size = 1024;
+    std::vector<sc::utils::Vec<float, 3>> pixels(size * size);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> color(0.f, 1.f);
+    for (auto& p : pixels)
+        p = sc::utils::Vec<float, 3>{color(rng), color(rng), color(rng)};
+    const mrc::Texture<fpT> texture(std::move(pixels), size, size);
+
+    // coherent: a scanline across the texture, random: scattered lookups
+    std::vector<Vec2> coherent(arraySize);
+    std::vector<Vec2> scattered(arraySize);
+    std::uniform_real_distribution<fpT> uv(0.f, 1.f);
+    for (std::size_t i = 0; i < arraySize; ++i)
+    {
+        coherent[i] = Vec2{static_cast<fpT>(i) / arraySize, .5f};
+        scattered[i] = Vec2{uv(rng), uv(rng)};
+    }
+
+    std::vector<sc::utils::Vec<float, 3>> out(arraySize);
+    auto sampleAll = [&](const std::vector<Vec2>& coords) {
+        return [&]() {
+            for (std::size_t i = 0; i < arraySize; ++i)
+                out[i] = texture.sample(coords[i]);
+            bench::doNotOptimize(out);
+        };
+    };
+    suite.run("texture/sample_coherent", sampleAll(coherent), arraySize);
+    suite.run("texture/sample_random", sampleAll(scattered), arraySize);
+}
+
+void objCases(Suite& suite, const Options& options)
+{
+    const std::string path = options.obj.empty() ? writeLargeObj(200000) : options.obj;
+    if (!std::filesystem::exists(path))
+    {
+        std::cerr << "io/readFromObjFile: skipped, missing " << path << '\n';
+        return;
+    }
+
+    const std::size_t faces = mrc::io::readFromObjFile<fpT>(path.c_str()).faces().size();
+    suite.run("io/readFromObjFile", [&]() {
+        auto model = mrc::io::readFromObjFile<fpT>(path.c_str());
+        bench::doNotOptimize(model.faces().data());
+    }, faces);
+}
+
+void rasterCases(Suite& suite)
+{
+    constexpr int width = 512;
+    constexpr int height = 512;
+
+    sc::Camera<fpT, sc::VecArray> camera;
+    camera.setRes(Vec2{static_cast<fpT>(width), static_cast<fpT>(height)});
+    camera.setLen(0.3);
+    const Mat4 viewProj = mrc::getProjectionMatrix(camera) * mrc::getViewMatrix(camera);
+
+    // triangles in front of the camera, a quarter of them crossing the near plane
+    std::vector<std::array<mrc::internal::ClipVertex<fpT>, 3>> clipTris(arraySize);
+    {
+        const auto centers = randomVectors(arraySize, -1.f, 1.f, 6);
+        for (std::size_t i = 0; i < arraySize; ++i)
+        {
+            Vec3 c = centers[i];
+            c[2] = i % 4 == 0 ? 0.f : -2.f - c[2];
+            clipTris[i] = {
+                mrc::wsToClip(c + Vec3{-.1f, -.1f, 0.f}, viewProj),
+                mrc::wsToClip(c + Vec3{.1f, -.1f, 0.f}, viewProj),
+                mrc::wsToClip(c + Vec3{0.f, .1f, -.2f}, viewProj),
+            };
+        }
+    }
+
+    suite.run("gt/clipAndProject", [&]() {
+        std::array<std::array<mrc::internal::ProjectedVertex<fpT>, 3>, 2> out;
+        std::size_t total = 0;
+        for (const auto& tri : clipTris)
+            total += mrc::gt::clipAndProject(tri, camera, out);
+        bench::doNotOptimize(total);
+        bench::doNotOptimize(out);
+    }, arraySize);
+
+    sc::FrameBuffer frame(width, height);
+    mrc::DepthBuffer<fpT> zBuffer(static_cast<std::size_t>(width), static_cast<std::size_t>(height));
+    const std::vector<mrc::LightSource<fpT>> lights;
+    mrc::internal::SceneCache<fpT> cache{frame, camera, zBuffer, lights};
+
+    auto shader = [](const mrc::FragmentInput<fpT>& frag) {
+        return sc::utils::Vec<float, 3>{frag.normal[0], frag.normal[1], frag.depth};
+    };
+
+    for (const fpT size : {4.f, 32.f, 256.f})
+    {
+        const auto tri = makeTriangle(width * .5f, height * .5f, size);
+
+        // depth is reset every time, so each pass shades every covered
+        // pixel instead of failing the depth test
+        const std::size_t pixels = static_cast<std::size_t>(size * size * .43f);
+        suite.run("gt/rasterizeTriangleInRect/" + std::to_string(static_cast<int>(size)) + "px", [&]() {
+            zBuffer.clear();
+            mrc::gt::rasterizeTriangleInRect(tri, shader, cache, 0, 0, width, height);
+            bench::doNotOptimize(frame);
+        }, std::max<std::size_t>(pixels, 1));
+    }
+}
+
+void rayMarchCases(Suite& suite)
+{
+    const rmc::Scene<fpT> scene = black_hole::makeScene<fpT>();
+
+    const auto points = randomVectors(arraySize, -2.f, 2.f, 7);
+    suite.run("rmc/Scene::sdf", [&]() {
+        rmc::internal::SdfResult<fpT> result;
+        fpT sum = 0;
+        for (const auto& p : points)
+        {
+            scene.sdf(p, result);
+            sum += result.distance;
+        }
+        bench::doNotOptimize(sum);
+    }, arraySize);
+
+    // a 32x32 fan of rays from the example camera position, about half of
+    // them hitting the spheres
+    constexpr std::size_t side = 32;
+    std::vector<sc::utils::Ray<fpT, 3>> rays;
+    rays.reserve(side * side);
+    for (std::size_t y = 0; y < side; ++y)
+    {
+        for (std::size_t x = 0; x < side; ++x)
+        {
+            const fpT u = static_cast<fpT>(x) / side * 2.f - 1.f;
+            const fpT v = static_cast<fpT>(y) / side * 2.f - 1.f;
+            rays.emplace_back(Vec3{0.f, 0.f, 2.f}, sc::utils::norm(Vec3{u, v, -1.5f}));
+        }
+    }
+
+    suite.run("rmc/marchRay", [&]() {
+        std::size_t hits = 0;
+        for (const auto& ray : rays)
+            hits += rmc::marchRay(ray, scene).reachedThreshold;
+        bench::doNotOptimize(hits);
+    }, rays.size());
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--counters")
+        {
+            options.params.counters = true;
+            continue;
+        }
+
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value)
+        {
+            std::cerr << "usage: micro_bench [--filter TEXT] [--warmup N] [--reps N] [--min-batch-ms MS]"
+                         " [--counters] [--obj FILE] [--json FILE|-] [--csv FILE|-]\n";
+            return false;
+        }
+        ++i;
+
+        if (arg == "--filter")
+            options.filter = value;
+        else if (arg == "--warmup")
+            options.params.warmup = std::strtoull(value, nullptr, 10);
+        else if (arg == "--reps")
+            options.params.repetitions = std::strtoull(value, nullptr, 10);
+        else if (arg == "--min-batch-ms")
+            options.params.minBatchMs = std::strtod(value, nullptr);
+        else if (arg == "--obj")
+            options.obj = value;
+        else if (arg == "--json")
+            options.json = value;
+        else if (arg == "--csv")
+            options.csv = value;
+        else
+        {
+            std::cerr << "unknown option " << arg << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    if (options.params.counters && !bench::PerfCounters().valid())
+        std::cerr << "hardware counters unavailable, reporting timings only\n";
+
+    Suite suite(options);
+    vecMatCases(suite);
+    textureCases(suite);
+    objCases(suite, options);
+    rasterCases(suite);
+    rayMarchCases(suite);
+
+    const auto writeJson = [](std::ostream& os, const auto& results) { bench::writeJson(os, results); };
+    const auto writeCsv = [](std::ostream& os, const auto& results) { bench::writeCsv(os, results); };
+    bool written = true;
+    if (!options.json.empty())
+        written &= bench::writeReport(options.json, suite.results(), writeJson);
+    if (!options.csv.empty())
+        written &= bench::writeReport(options.csv, suite.results(), writeCsv);
+
+    return suite.results().empty() || !written ? 1 : 0;
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench
+{
+
+/// Keeps @p value alive, so the compiler cannot drop the code computing it.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/// Schedule of one micro-benchmark.
+struct MicroParams
+{
+    /// Untimed batches run before measuring.
+    std::size_t warmup = 3;
+    /// Timed batches; the statistics are over these.
+    std::size_t repetitions = 15;
+    /// Operations per batch grow until a batch takes at least this long,
+    /// keeping clock resolution out of the result.
+    double minBatchMs = 5.0;
+    bool counters = false;
+};
+
+/// Per-operation statistics over the timed batches. itemsPerOp scales the
+/// rates when one operation processes a whole array.
+struct MicroResult
+{
+    std::string name;
+    std::size_t batch = 0;
+    std::size_t repetitions = 0;
+    std::size_t itemsPerOp = 1;
+    double minNs = 0.0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double maxNs = 0.0;
+
+    /// Hardware counters per operation, summed over all timed batches;
+    /// counters is false when they were not requested or not available.
+    bool counters = false;
+    double cycles = 0.0;
+    double instructions = 0.0;
+    double cacheMisses = 0.0;
+    double branchMisses = 0.0;
+
+    [[nodiscard]] double itemsPerS() const
+    {
+        return medianNs > 0.0 ? 1e9 * static_cast<double>(itemsPerOp) / medianNs : 0.0;
+    }
+};
+
+/// Cycles, instructions, cache and branch misses of the calling thread,
+/// read through perf_event_open(). Opening fails without kernel support or
+/// when perf_event_paranoid forbids it; valid() then stays false and the
+/// harness reports timings only.
+class PerfCounters
+{
+public:
+    static constexpr std::size_t count = 4;
+
+    PerfCounters()
+    {
+#if defined(__linux__)
+        constexpr std::array<std::uint64_t, count> configs = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            perf_event_attr attr{ };
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            const int group = i == 0 ? -1 : _fds[0];
+            _fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+            if (_fds[i] < 0)
+            {
+                close();
+                return;
+            }
+        }
+        _valid = true;
+#endif
+    }
+
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool valid() const { return _valid; }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (!_valid)
+            return;
+        ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /// Stops counting and returns the counts since start().
+    std::array<std::uint64_t, count> stop()
+    {
+        std::array<std::uint64_t, count> values{ };
+#if defined(__linux__)
+        if (!_valid)
+            return values;
+        ioctl(_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // PERF_FORMAT_GROUP: number of events, then one value per event
+        std::array<std::uint64_t, count + 1> buffer{ };
+        if (read(_fds[0], buffer.data(), sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)))
+            std::copy(buffer.begin() + 1, buffer.end(), values.begin());
+#endif
+        return values;
+    }
+
+private:
+    std::array<int, count> _fds{-1, -1, -1, -1};
+    bool _valid = false;
+
+    void close()
+    {
+#if defined(__linux__)
+        for (int& fd : _fds)
+        {
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+#endif
+        _valid = false;
+    }
+};
+
+/// Times @p op, a callable run once per operation. The batch size is
+/// calibrated first, then @p params.warmup untimed and
+/// @p params.repetitions timed batches run back to back.
+template<typename Operation>
+MicroResult runMicro(const std::string& name, const MicroParams& params, Operation&& op,
+                     std::size_t itemsPerOp = 1)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto runBatch = [&op](std::size_t batch) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i)
+            op();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    MicroResult result;
+    result.name = name;
+    result.itemsPerOp = itemsPerOp;
+
+    const double minBatchNs = params.minBatchMs * 1e6;
+    std::size_t batch = 1;
+    for (double ns = runBatch(batch); ns < minBatchNs && batch < (std::size_t(1) << 30); ns = runBatch(batch))
+    {
+        // aim slightly past the target from the measured rate
+        const double scale = ns > 0.0 ? 1.2 * minBatchNs / ns : 10.0;
+        batch = std::max(batch + 1, static_cast<std::size_t>(static_cast<double>(batch) * std::min(scale, 10.0)));
+    }
+    result.batch = batch;
+
+    for (std::size_t i = 0; i < params.warmup; ++i)
+        runBatch(batch);
+
+    PerfCounters counters;
+    const bool counting = params.counters && counters.valid();
+    std::array<std::uint64_t, PerfCounters::count> totals{ };
+
+    const std::size_t reps = std::max<std::size_t>(params.repetitions, 1);
+    std::vector<double> perOp;
+    perOp.reserve(reps);
+    for (std::size_t i = 0; i < reps; ++i)
+    {
+        if (counting)
+            counters.start();
+        const double ns = runBatch(batch);
+        if (counting)
+        {
+            const auto values = counters.stop();
+            for (std::size_t c = 0; c < totals.size(); ++c)
+                totals[c] += values[c];
+        }
+        perOp.push_back(ns / static_cast<double>(batch));
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    double sum = 0.0;
+    for (double ns : perOp)
+        sum += ns;
+    const double mean = sum / static_cast<double>(reps);
+    double squares = 0.0;
+    for (double ns : perOp)
+        squares += (ns - mean) * (ns - mean);
+
+    result.repetitions = reps;
+    result.minNs = perOp.front();
+    result.maxNs = perOp.back();
+    result.meanNs = mean;
+    result.medianNs = reps % 2
+        ? perOp[reps / 2]
+        : (perOp[reps / 2 - 1] + perOp[reps / 2]) * .5;
+    result.stddevNs = reps > 1 ? std::sqrt(squares / static_cast<double>(reps - 1)) : 0.0;
+
+    if (counting)
+    {
+        const double ops = static_cast<double>(batch * reps);
+        result.counters = true;
+        result.cycles = static_cast<double>(totals[0]) / ops;
+        result.instructions = static_cast<double>(totals[1]) / ops;
+        result.cacheMisses = static_cast<double>(totals[2]) / ops;
+        result.branchMisses = static_cast<double>(totals[3]) / ops;
+    }
+    return result;
+}
+
+inline void writeText(std::ostream& os, const MicroResult& r)
+{
+    os << std::left << std::setw(34) << r.name << std::right
+       << std::fixed << std::setprecision(1)
+       << " median " << std::setw(11) << r.medianNs
+       << " min " << std::setw(11) << r.minNs
+       << " mean " << std::setw(11) << r.meanNs
+       << " sd " << std::setw(9) << r.stddevNs << " ns/op";
+    if (r.itemsPerOp > 1)
+        os << std::scientific << std::setprecision(3) << "  items/s " << r.itemsPerS();
+    if (r.counters)
+    {
+        os << std::fixed << std::setprecision(1)
+           << "  cyc " << r.cycles
+           << " ins " << r.instructions
+           << " cmiss " << r.cacheMisses
+           << " bmiss " << r.branchMisses;
+    }
+    os << std::defaultfloat << '\n';
+}
+
+inline void writeJson(std::ostream& os, const std::vector<MicroResult>& results)
+{
+    os << std::setprecision(9) << "{\"results\":[";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const MicroResult& r = results[i];
+        os << (i ? ",\n" : "\n")
+           << "{\"name\":\"" << r.name << '"'
+           << ",\"batch\":" << r.batch
+           << ",\"repetitions\":" << r.repetitions
+           << ",\"items_per_op\":" << r.itemsPerOp
+           << ",\"ns_min\":" << r.minNs
+           << ",\"ns_median\":" << r.medianNs
+           << ",\"ns_mean\":" << r.meanNs
+           << ",\"ns_stddev\":" << r.stddevNs
+           << ",\"ns_max\":" << r.maxNs
+           << ",\"items_per_s\":" << r.itemsPerS();
+        if (r.counters)
+        {
+            os << ",\"cycles\":" << r.cycles
+               << ",\"instructions\":" << r.instructions
+               << ",\"cache_misses\":" << r.cacheMisses
+               << ",\"branch_misses\":" << r.branchMisses;
+        }
+        os << '}';
+    }
+    os << "\n]}\n";
+}
+
+/// Counter columns are empty when counters were not collected.
+inline void writeCsv(std::ostream& os, const std::vector<MicroResult>& results)
+{
+    os << "name,batch,repetitions,items_per_op,ns_min,ns_median,ns_mean,ns_stddev,ns_max,items_per_s,"
+          "cycles,instructions,cache_misses,branch_misses\n";
+    os << std::setprecision(9);
+    for (const MicroResult& r : results)
+    {
+        os << r.name << ',' << r.batch << ',' << r.repetitions << ',' << r.itemsPerOp << ','
+           << r.minNs << ',' << r.medianNs << ',' << r.meanNs << ',' << r.stddevNs << ','
+           << r.maxNs << ',' << r.itemsPerS() << ',';
+        if (r.counters)
+            os << r.cycles << ',' << r.instructions << ',' << r.cacheMisses << ',' << r.branchMisses;
+        else
+            os << ",,,";
+        os << '\n';
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,344 @@
+#include "bench_report.h"
+#include "black_hole_scene.h"
+#include "main_pipeline.h"
+#include "model/io.h"
+#include "offline_render.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless throughput benchmark of the rasterizer and the ray marcher.
+// Every scene renders a fixed camera path through the offline drivers, so
+// runs are comparable across machines and releases.
+//
+//   render_bench [--frames N] [--warmup N] [--size WxH] [--threads N]
+//                [--scene NAME] [--json FILE] [--csv FILE]
+
+namespace
+{
+
+using fpT = float;
+
+struct Options
+{
+    std::size_t frames = 120;
+    std::size_t warmup = 10;
+    std::size_t width = 800;
+    std::size_t height = 600;
+    std::size_t threads = 0;
+    std::string scene;
+    std::string json;
+    std::string csv;
+};
+
+struct RasterScene
+{
+    const char* name;
+    const char* objPath;  // relative to ASSETS_DIR
+    fpT distance;
+    bool textured;        // attach a procedural texture when the material has none
+};
+
+constexpr RasterScene rasterScenes[] = {
+    {"monke", "model_render_core_example/monke.obj", 2.f, false},
+    {"cube", "model_render_core_example/cube.obj", 4.f, false},
+    {"rock_textured", "mrc_texture_example/objects/rock.obj", 2.f, true},
+    {"cone_textured", "mrc_texture_example/cone.obj", .8f, true},
+};
+
+/// 256x256 checkerboard, so textured scenes sample even without their images.
+std::shared_ptr<mrc::Texture<fpT>> makeCheckerTexture()
+{
+    constexpr std::size_t size = 256;
+    std::vector<sc::utils::Vec<float, 3>> pixels(size * size);
+    for (std::size_t y = 0; y < size; ++y)
+    {
+        for (std::size_t x = 0; x < size; ++x)
+        {
+            const bool odd = ((x / 16) + (y / 16)) % 2;
+            pixels[y * size + x] = odd
+                ? sc::utils::Vec<float, 3>{.9f, .8f, .6f}
+                : sc::utils::Vec<float, 3>{.3f, .2f, .1f};
+        }
+    }
+    return std::make_shared<mrc::Texture<fpT>>(std::move(pixels), size, size);
+}
+
+/// Shaded-fragment count kept per rendering thread and summed once the
+/// frames are done, so counting does not make every fragment contend on
+/// one shared cache line.
+class FragmentCounter
+{
+public:
+    void add() { ++local().value; }
+
+    /// Only valid while no frame is rendering.
+    [[nodiscard]] std::size_t total()
+    {
+        std::lock_guard lock(_mutex);
+        std::size_t sum = 0;
+        for (const auto& slot : _slots)
+            sum += slot.value;
+        return sum;
+    }
+
+    void reset()
+    {
+        std::lock_guard lock(_mutex);
+        for (auto& slot : _slots)
+            slot.value = 0;
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::size_t value = 0;
+    };
+
+    Slot& local()
+    {
+        // keyed by id rather than address: a later counter may reuse it
+        thread_local std::uint64_t owner = 0;
+        thread_local Slot* slot = nullptr;
+        if (owner != _id)
+        {
+            std::lock_guard lock(_mutex);
+            slot = &_slots.emplace_back();
+            owner = _id;
+        }
+        return *slot;
+    }
+
+    static std::uint64_t nextId()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const std::uint64_t _id = nextId();
+    std::mutex _mutex;
+    std::deque<Slot> _slots;
+};
+
+/// Orbits the origin once over @p frames, looking at it from @p distance.
+void placeOnOrbit(sc::Camera<fpT, sc::VecArray>& camera, std::size_t frame, std::size_t frames, fpT distance)
+{
+    const fpT angle = fpT(2 * M_PI) * static_cast<fpT>(frame) / static_cast<fpT>(std::max<std::size_t>(frames, 1));
+    const fpT pitch = fpT(-.2);
+    camera.rot() = sc::utils::Vec<fpT, 3>{pitch, angle, fpT(0)};
+    camera.pos() = mrc::getForward(camera.rot()) * -distance;
+}
+
+sc::utils::FrameStats::Summary summarize(const sc::utils::FrameStats& stats)
+{
+    return stats.summary();
+}
+
+bench::Result runRaster(const RasterScene& scene, const Options& options)
+{
+    bench::Result result;
+    result.name = scene.name;
+    result.kind = "raster";
+    result.width = options.width;
+    result.height = options.height;
+
+    auto model = mrc::readFromObjFile<fpT>((std::string(ASSETS_DIR) + "/" + scene.objPath).c_str());
+    if (scene.textured && !model.material.diffuseMap)
+        model.material.diffuseMap = makeCheckerTexture();
+
+    std::vector<mrc::Model<fpT>> models;
+    models.push_back(std::move(model));
+    const std::vector<mrc::LightSource<fpT>> lights = {mrc::LightSource<fpT>{
+        sc::utils::Vec<fpT, 3>{0.f, 3.f, 2.f},
+        sc::utils::Vec<fpT, 3>{0.f, -1.f, -.5f},
+        sc::utils::Vec<fpT, 3>{1.f, 1.f, 1.f},
+        1.f
+    }};
+
+    sc::Camera<fpT, sc::VecArray> camera;
+    camera.setRes(sc::utils::Vec<fpT, 2>{static_cast<fpT>(options.width), static_cast<fpT>(options.height)});
+    camera.setLen(0.3);
+
+    // counts shaded fragments around the default shader; used only in an
+    // untimed replay, so the timed frames run the plain shader
+    FragmentCounter fragments;
+    auto countingShader = [&fragments](const mrc::Model<fpT>& m) {
+        return [&fragments, shade = mrc::internal::DefaultShaderFactory<fpT>{}(m)](
+            const mrc::FragmentInput<fpT>& frag) {
+            fragments.add();
+            return shade(frag);
+        };
+    };
+
+    const std::size_t total = options.warmup + options.frames;
+    auto path = [&camera, &scene, total](std::size_t frame, std::size_t) {
+        placeOnOrbit(camera, frame, total, scene.distance);
+    };
+    placeOnOrbit(camera, 0, total, scene.distance);
+
+    sc::utils::FrameStats stats(std::max<std::size_t>(options.frames, 1));
+    sc::RenderParams params;
+    params.threadCount = options.threads;
+    result.threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    sc::OfflineParams warmup{.frameCount = options.warmup};
+    mrc::renderMrcOffline(camera, models, lights, path, { }, warmup, params);
+
+    params.frameStats = &stats;
+    sc::OfflineParams measured{.frameCount = options.frames, .firstFrame = options.warmup};
+    mrc::renderMrcOffline(camera, models, lights, path, { }, measured, params);
+
+    // the camera path is a function of the frame index, so replaying the
+    // measured frames shades exactly the fragments that were timed
+    params.frameStats = nullptr;
+    mrc::renderMrcOffline(camera, models, lights, path, { }, measured, params, countingShader);
+
+    result.frame = summarize(stats);
+    const double seconds = result.frame.meanMs * static_cast<double>(options.frames) / 1000.0;
+    if (seconds > 0.0)
+    {
+        result.trianglesPerS = static_cast<double>(models.front().faces().size() * options.frames) / seconds;
+        result.fragmentsPerS = static_cast<double>(fragments.total()) / seconds;
+    }
+    return result;
+}
+
+bench::Result runBlackHole(const Options& options)
+{
+    bench::Result result;
+    result.name = "black_hole";
+    result.kind = "ray_march";
+    result.width = options.width;
+    result.height = options.height;
+
+    const rmc::Scene<fpT> scene = black_hole::makeScene<fpT>();
+
+    sc::Camera<fpT, sc::VecArray> camera;
+    camera.setRes(sc::utils::Vec<fpT, 2>{static_cast<fpT>(options.width), static_cast<fpT>(options.height)});
+    camera.pos() = sc::utils::Vec<fpT, 3>{0.f, 0.f, 2.f};
+    camera.setLen(0.4);
+
+    // same vertical sweep as the black_hole_shader example
+    auto path = [&camera](std::size_t frame, std::size_t) {
+        camera.pos()[1] = std::sin(static_cast<fpT>(frame) / 100.f);
+    };
+    auto shade = [&scene](const sc::PixelSample<fpT>& ps, std::size_t, std::size_t) {
+        return black_hole::shaderFunction(ps, scene);
+    };
+
+    sc::utils::FrameStats stats(std::max<std::size_t>(options.frames, 1));
+    sc::RenderParams params;
+    params.threadCount = options.threads;
+    result.threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    sc::OfflineParams warmup{.frameCount = options.warmup};
+    sc::renderEachPixelOffline(camera, shade, path, warmup, params);
+
+    params.frameStats = &stats;
+    sc::OfflineParams measured{.frameCount = options.frames, .firstFrame = options.warmup};
+    sc::renderEachPixelOffline(camera, shade, path, measured, params);
+
+    result.frame = summarize(stats);
+    const double seconds = result.frame.meanMs * static_cast<double>(options.frames) / 1000.0;
+    if (seconds > 0.0)
+        result.raysPerS = static_cast<double>(options.width * options.height * options.frames) / seconds;
+    return result;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        auto number = [&]() { ++i; return static_cast<std::size_t>(std::strtoull(value, nullptr, 10)); };
+
+        if (!value && arg != "--help")
+        {
+            std::cerr << "missing value for " << arg << '\n';
+            return false;
+        }
+        if (arg == "--frames")
+            options.frames = number();
+        else if (arg == "--warmup")
+            options.warmup = number();
+        else if (arg == "--threads")
+            options.threads = number();
+        else if (arg == "--size")
+        {
+            ++i;
+            if (std::sscanf(value, "%zux%zu", &options.width, &options.height) != 2)
+            {
+                std::cerr << "--size expects WxH\n";
+                return false;
+            }
+        }
+        else if (arg == "--scene")
+            options.scene = argv[++i];
+        else if (arg == "--json")
+            options.json = argv[++i];
+        else if (arg == "--csv")
+            options.csv = argv[++i];
+        else
+        {
+            std::cerr << "usage: render_bench [--frames N] [--warmup N] [--size WxH] [--threads N]"
+                         " [--scene NAME] [--json FILE] [--csv FILE]\n";
+            return false;
+        }
+    }
+    return options.frames > 0 && options.width > 0 && options.height > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    auto selected = [&options](const char* name) {
+        return options.scene.empty() || options.scene == name;
+    };
+
+    std::vector<bench::Result> results;
+
+    for (const auto& scene : rasterScenes)
+    {
+        if (!selected(scene.name))
+            continue;
+        if (!std::filesystem::exists(std::string(ASSETS_DIR) + "/" + scene.objPath))
+        {
+            std::cerr << scene.name << ": skipped, missing " << scene.objPath << '\n';
+            continue;
+        }
+        results.push_back(runRaster(scene, options));
+        bench::writeText(std::cout, results.back());
+    }
+
+    if (selected("black_hole"))
+    {
+        results.push_back(runBlackHole(options));
+        bench::writeText(std::cout, results.back());
+    }
+
+    bool written = true;
+    if (!options.json.empty())
+        written &= bench::writeReport(options.json, results, bench::writeJson);
+    if (!options.csv.empty())
+        written &= bench::writeReport(options.csv, results, bench::writeCsv);
+
+    return results.empty() || !written ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "utils/revision.h"
 #include "utils/vec.h"
 #include "camera_view.h"
 
@@ -41,49 +42,60 @@ public:
     const auto& size() const { return _size; }
     NumericT len() const { return _len; }
     NumericT sideRatio() const { return _res[0] / _res[1]; }
+    /// Changes on every setter and mutable accessor call.
+    const utils::Revision& revision() const { return _revision; }
+    /// Records an edit made through a reference held across frames.
+    void markDirty() { _revision.touch(); }
 
     // Setters
-    auto& rot() { return _rot; }
-    auto& pos() { return _pos; }
+    auto& rot() { _revision.touch(); return _rot; }
+    auto& pos() { _revision.touch(); return _pos; }
 
     void setRes(const Vec2& res)
     {
+        _revision.touch();
         _res = res;
         setRatioFromRes();
     }
 
     void setResX(NumericT res)
     {
+        _revision.touch();
         _res[0] = res;
         setRatioFromRes();
     }
 
     void setResY(NumericT res)
     {
+        _revision.touch();
         _res[1] = res;
         setRatioFromRes();
     }
 
     void setSize(const Vec2& sz)
     {
+        _revision.touch();
         _size = sz;
         setRatioFromSize();
     }
 
     void setSizeX(NumericT sz)
     {
+        _revision.touch();
         _size[0] = sz;
         setRatioFromSize();
     }
 
     void setSizeY(NumericT sz)
     {
+        _revision.touch();
         _size[1] = sz;
         setRatioFromSize();
     }
 
     void setLen(NumericT len)
     {
+        _revision.touch();
         _len = len;
     }
 
@@ -111,14 +123,17 @@ private:
     Vec2 _size;
     /// \var NumericT _len camera focal length in meters
     NumericT _len;
+    utils::Revision _revision;
 };
 
+/// View of @p camera sampled by @p width x @p height pixels; the screen
+/// plane, and so the field of view, stays the camera's.
 template<
     typename NumericT,
     template<typename, std::size_t> typename VecT
 >
 internal::CameraView<NumericT>
-makeViewFromCamera(const Camera<NumericT, VecT>& camera)
+makeViewFromCamera(const Camera<NumericT, VecT>& camera, std::size_t width, std::size_t height)
 {
     using Vec3 = utils::Vec<NumericT, 3>;
     using Vec2 = utils::Vec<NumericT, 2>;
@@ -141,11 +156,10 @@ makeViewFromCamera(const Camera<NumericT, VecT>& camera)
     view.right = right;
     view.up = up;
 
-    const Vec2 res = camera.res();
     const Vec2 size = camera.size();
 
-    view.width = static_cast<std::size_t>(res[0]);
-    view.height = static_cast<std::size_t>(res[1]);
+    view.width = width;
+    view.height = height;
 
     const NumericT pixelW = size[0] / static_cast<NumericT>(view.width);
     const NumericT pixelH = size[1] / static_cast<NumericT>(view.height);
@@ -171,4 +185,16 @@ makeViewFromCamera(const Camera<NumericT, VecT>& camera)
     return view;
 }
 
-} // namespace sc
\ No newline at end of file
+template<
+    typename NumericT,
+    template<typename, std::size_t> typename VecT
+>
+internal::CameraView<NumericT>
+makeViewFromCamera(const Camera<NumericT, VecT>& camera)
+{
+    return makeViewFromCamera(camera,
+        static_cast<std::size_t>(camera.res()[0]),
+        static_cast<std::size_t>(camera.res()[1]));
+}
+
+} // namespace sc
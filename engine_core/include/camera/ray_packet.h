@@ -0,0 +1,96 @@
+#pragma once
+
+#include "camera_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace sc
+{
+
+/// Structure-of-arrays batch of N camera rays for SIMD shaders.
+/// Directions are normalized. Lanes at and past count repeat the last
+/// active ray, so a shader may always process all N lanes.
+template<typename NumericT, std::size_t N>
+struct RayPacket
+{
+    static_assert(N == 4 || N == 8 || N == 16, "RayPacket supports 4, 8 or 16 lanes");
+    static constexpr std::size_t width = N;
+
+    alignas(64) NumericT originX[N];
+    alignas(64) NumericT originY[N];
+    alignas(64) NumericT originZ[N];
+
+    alignas(64) NumericT dirX[N];
+    alignas(64) NumericT dirY[N];
+    alignas(64) NumericT dirZ[N];
+
+    /// Same screen coordinates as PixelSample::uv.
+    alignas(64) NumericT u[N];
+    alignas(64) NumericT v[N];
+
+    alignas(64) std::uint32_t pixelX[N];
+    alignas(64) std::uint32_t pixelY[N];
+
+    std::size_t count = 0;
+};
+
+/// Shading result of a RayPacket, one color per lane.
+template<std::size_t N>
+struct ColorPacket
+{
+    static constexpr std::size_t width = N;
+
+    alignas(64) float r[N];
+    alignas(64) float g[N];
+    alignas(64) float b[N];
+};
+
+/// Fills @p packet with the rays of @p count pixels of row @p y, starting
+/// at column @p x and advancing @p step columns per lane.
+template<typename NumericT, std::size_t N>
+inline void generateRayPacket(const internal::CameraView<NumericT>& view,
+                              std::size_t x,
+                              std::size_t y,
+                              std::size_t count,
+                              std::size_t step,
+                              RayPacket<NumericT, N>& packet)
+{
+    count = std::clamp<std::size_t>(count, 1, N);
+    packet.count = count;
+
+    const NumericT fy = static_cast<NumericT>(y);
+    const NumericT baseX = view.pixelOrigin[0] + view.stepY[0] * fy;
+    const NumericT baseY = view.pixelOrigin[1] + view.stepY[1] * fy;
+    const NumericT baseZ = view.pixelOrigin[2] + view.stepY[2] * fy;
+
+    const NumericT uvStepX = NumericT(2) / static_cast<NumericT>(view.width);
+    const NumericT halfH = NumericT(view.height) * NumericT(.5);
+    const NumericT v = (fy - halfH) / halfH;
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const std::size_t px = x + std::min(i, count - 1) * step;
+        const NumericT fx = static_cast<NumericT>(px);
+
+        const NumericT dx = baseX + view.stepX[0] * fx;
+        const NumericT dy = baseY + view.stepX[1] * fx;
+        const NumericT dz = baseZ + view.stepX[2] * fx;
+        const NumericT invLen = NumericT(1) / std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        packet.originX[i] = view.origin[0];
+        packet.originY[i] = view.origin[1];
+        packet.originZ[i] = view.origin[2];
+        packet.dirX[i] = dx * invLen;
+        packet.dirY[i] = dy * invLen;
+        packet.dirZ[i] = dz * invLen;
+        packet.u[i] = NumericT(-1) + fx * uvStepX;
+        packet.v[i] = v;
+        packet.pixelX[i] = static_cast<std::uint32_t>(px);
+        packet.pixelY[i] = static_cast<std::uint32_t>(y);
+    }
+}
+
+} // namespace sc
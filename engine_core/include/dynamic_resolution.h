@@ -0,0 +1,123 @@
+#pragma once
+
+#include "frame_buffer.h"
+#include "render_params.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+namespace sc
+{
+
+/// Picks the render resolution of the next frame from the measured render
+/// time of the previous ones.
+///
+/// Render time is taken as proportional to the pixel count, so a frame
+/// over budget by a factor k shrinks both axes by sqrt(k). The time is
+/// smoothed over adjustInterval frames and the scale changes at most once
+/// per interval; it shrinks whenever the budget is exceeded but grows only
+/// while frames stay under 75% of it, so it does not oscillate around the
+/// budget. Scales snap to 1/64 steps.
+class DynamicResolution
+{
+public:
+    DynamicResolution(std::size_t maxWidth,
+                      std::size_t maxHeight,
+                      const DynamicResolutionParams& params,
+                      double frameBudgetMs)
+        : _maxWidth(std::max<std::size_t>(maxWidth, 1))
+        , _maxHeight(std::max<std::size_t>(maxHeight, 1))
+        , _params(params)
+        , _budgetMs(params.targetMs > 0.0 ? params.targetMs : frameBudgetMs)
+    {
+        _params.maxScale = std::clamp(_params.maxScale, 1.f / 64.f, 1.f);
+        _params.minScale = std::clamp(_params.minScale, 1.f / 64.f, _params.maxScale);
+        _params.adjustInterval = std::max<std::size_t>(_params.adjustInterval, 1);
+        setScale(_params.maxScale);
+    }
+
+    [[nodiscard]] float scale() const { return _scale; }
+    [[nodiscard]] std::size_t width() const { return _width; }
+    [[nodiscard]] std::size_t height() const { return _height; }
+    [[nodiscard]] double budgetMs() const { return _budgetMs; }
+
+    /// Feeds the render time of the frame just drawn; may change width()
+    /// and height() for the next one.
+    void update(double renderMs)
+    {
+        const double alpha = 2.0 / (static_cast<double>(_params.adjustInterval) + 1.0);
+        _smoothedMs = _frames == 0 ? renderMs : _smoothedMs + alpha * (renderMs - _smoothedMs);
+        if (++_frames < _params.adjustInterval || _budgetMs <= 0.0 || _smoothedMs <= 0.0)
+            return;
+
+        const bool over = _smoothedMs > _budgetMs;
+        const bool under = _smoothedMs < _budgetMs * .75;
+        if (!over && !under)
+            return;
+
+        // aim at 90% of the budget; grow by at most 25% per step
+        const double factor = std::sqrt(_budgetMs * .9 / _smoothedMs);
+        const float target = _scale * static_cast<float>(std::min(factor, 1.25));
+        const float previous = _scale;
+        setScale(target);
+
+        if (_scale != previous)
+        {
+            // the next frames are measured at the new size
+            _frames = 0;
+        }
+    }
+
+private:
+    std::size_t _maxWidth;
+    std::size_t _maxHeight;
+    DynamicResolutionParams _params;
+    double _budgetMs;
+    float _scale = 1.f;
+    std::size_t _width = 0;
+    std::size_t _height = 0;
+    double _smoothedMs = 0.0;
+    std::size_t _frames = 0;
+
+    void setScale(float scale)
+    {
+        scale = std::clamp(scale, _params.minScale, _params.maxScale);
+        _scale = std::clamp(std::round(scale * 64.f) / 64.f, _params.minScale, _params.maxScale);
+        _width = std::clamp<std::size_t>(
+            static_cast<std::size_t>(std::lround(static_cast<double>(_maxWidth) * _scale)), 1, _maxWidth);
+        _height = std::clamp<std::size_t>(
+            static_cast<std::size_t>(std::lround(static_cast<double>(_maxHeight) * _scale)), 1, _maxHeight);
+    }
+};
+
+namespace internal
+{
+
+/// Runs @p rf into @p renderer at the resolution chosen by @p resolution,
+/// or at the full capacity when it is null, and reports the render time
+/// back to it.
+template<typename Renderer, typename RenderFunction>
+void renderScaled(DynamicResolution* resolution,
+                  Renderer& renderer,
+                  RenderFunction& rf,
+                  std::size_t frame,
+                  std::size_t time)
+{
+    if (!resolution)
+    {
+        rf(renderer, frame, time);
+        return;
+    }
+
+    renderer.resize(resolution->width(), resolution->height());
+    const auto start = std::chrono::steady_clock::now();
+    rf(renderer, frame, time);
+    resolution->update(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace internal
+
+} // namespace sc
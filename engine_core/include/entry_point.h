@@ -1,14 +1,16 @@
 #pragma once
 
 #include "window.h"
+#include "dynamic_resolution.h"
+#include "frame_exchange.h"
+#include "utils/frame_pacer.h"
+#include "utils/profiler.h"
 
+#include <atomic>
 #include <chrono>
+#include <optional>
 #include <thread>
 
-#ifdef ENABLE_LOG
-#include <iostream>
-#endif
-
 namespace sc
 {
 
@@ -19,33 +21,90 @@ template<typename RenderFunction,
 void runMainRenderThread(GLFWRenderer& renderer,
     RenderFunction rf,
     EachFrameUpdate efu,
-    float targetFrameRateMsPerFrame)
+    float targetFrameRateMsPerFrame,
+    utils::FrameStats* stats = nullptr)
 {
+    utils::FramePacer pacer(targetFrameRateMsPerFrame, stats);
     std::size_t time = 0;
     std::size_t frame = 0;
     while (!renderer.shouldClose())
     {
-        auto start = std::chrono::system_clock::now();
+        SC_PROFILE_FRAME(frame);
         rf(renderer, frame++, time);
-        renderer.show();
-        efu(frame, time);
-        auto end = std::chrono::system_clock::now();
-        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        int targetFrameRateDiff = static_cast<int>(targetFrameRateMsPerFrame) - static_cast<int>(elapsedTime);
-        if (targetFrameRateDiff > 0)
-            std::this_thread::sleep_for(std::chrono::milliseconds(targetFrameRateDiff));
-        end = std::chrono::system_clock::now();
-        elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        time += elapsedTime;
+        {
+            SC_PROFILE_STAGE(Present);
+            renderer.show();
+        }
+        {
+            SC_PROFILE_STAGE(Update);
+            efu(frame, time);
+        }
+        pacer.wait();
+        time = static_cast<std::size_t>(pacer.elapsedMs());
 #ifdef ENABLE_LOG
-        std::cout << "[FRAME]: " << frame << " ";
-        std::cout << "[TIME ms]:  " << time << " ";
-        std::cout << "[RENDER TIME ms]: " << elapsedTime << " ";
-        std::cout << "[FPS]: " << 1000. / static_cast<float>(elapsedTime) << "\n";
+        windowInternal::logFrameStats(frame, time, pacer.stats());
 #endif
     }
 }
 
+/// runMainRenderThread() with rendering moved off the main thread.
+/// The render thread draws into @p renderer's storage and publishes it
+/// through a FrameExchange; the main thread only polls events and presents
+/// the front buffer, so frame N+1 renders while frame N is uploaded.
+template<typename RenderFunction,
+         typename EachFrameUpdate = decltype([](std::size_t, std::size_t){ })>
+void runThreadedRender(GLFWRenderer& renderer,
+    RenderFunction rf,
+    EachFrameUpdate efu,
+    float targetFrameRateMsPerFrame,
+    std::size_t frameBufferCount,
+    utils::FrameStats* stats = nullptr)
+{
+    FrameBuffer front(
+        static_cast<int>(renderer.getRenderWidth()),
+        static_cast<int>(renderer.getRenderHeight()),
+        renderer.params());
+    internal::FrameExchange exchange(renderer, frameBufferCount);
+    std::atomic<bool> stop = false;
+
+    renderer.queueInput();
+
+    std::thread renderThread([&] {
+        utils::FramePacer pacer(targetFrameRateMsPerFrame, stats);
+        std::size_t time = 0;
+        std::size_t frame = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            SC_PROFILE_FRAME(frame);
+            renderer.dispatchInput();
+            rf(renderer, frame++, time);
+            exchange.publish(renderer);
+            {
+                SC_PROFILE_STAGE(Update);
+                efu(frame, time);
+            }
+            pacer.wait();
+            time = static_cast<std::size_t>(pacer.elapsedMs());
+#ifdef ENABLE_LOG
+            windowInternal::logFrameStats(frame, time, pacer.stats());
+#endif
+        }
+    });
+
+    while (!renderer.shouldClose())
+    {
+        glfwPollEvents();
+        if (exchange.acquire(front, std::chrono::milliseconds(2)))
+        {
+            SC_PROFILE_STAGE(Present);
+            renderer.presentFrame(front);
+        }
+    }
+
+    stop = true;
+    exchange.close();
+    renderThread.join();
+}
 
 template<typename NumericT,
     typename RenderFunction,
@@ -57,7 +116,8 @@ void initRender(
     const std::vector<std::pair<std::vector<int>, std::function<void()>>>& keyHandlers = { },
     const std::function<void(double, double)>& mouseHandler = { },
     utils::Vec<int, 2> windowResolution = utils::Vec<int, 2>{-1, -1},
-    unsigned int targetFrameRateMs = 60)
+    unsigned int targetFrameRateMs = 60,
+    const RenderParams& params = { })
 {
     using namespace std::chrono_literals;
 
@@ -73,7 +133,10 @@ void initRender(
     GLFWRenderer renderer(
         camera.res()[0],
         camera.res()[1],
-            windowRes
+            windowRes,
+            "Renderer",
+            params.upload,
+            params.frameBuffer
         );
 
     for (const auto& keyHandler : keyHandlers)
@@ -83,7 +146,26 @@ void initRender(
 
     renderer.onMouseMove(mouseHandler);
 
-    runMainRenderThread(renderer, rf, efu, targetFrameRateMsPerFrame);
+    if (params.capture)
+        renderer.onPresent([capture = params.capture](const FrameBuffer& frame) { capture->capture(frame); });
+
+    std::optional<DynamicResolution> resolution;
+    if (params.dynamicResolution.enabled)
+    {
+        resolution.emplace(renderer.capacityWidth(), renderer.capacityHeight(),
+                           params.dynamicResolution, targetFrameRateMsPerFrame);
+    }
+
+    auto scaled = [&rf, resolution = resolution ? &*resolution : nullptr](
+        GLFWRenderer& r, std::size_t frame, std::size_t time) {
+        internal::renderScaled(resolution, r, rf, frame, time);
+    };
+
+    if (params.threadedRender)
+        runThreadedRender(renderer, scaled, efu, targetFrameRateMsPerFrame,
+                          params.frameBufferCount, params.frameStats);
+    else
+        runMainRenderThread(renderer, scaled, efu, targetFrameRateMsPerFrame, params.frameStats);
 }
 
 } // namespace renderInternal
@@ -96,18 +178,22 @@ void initPerFrameRender(
     const std::vector<std::pair<std::vector<int>, std::function<void()>>>& keyHandlers = { },
     const std::function<void(double, double)>& mouseHandler = { },
     utils::Vec<int, 2> windowResolution = utils::Vec<int, 2>{-1, -1},
-    unsigned int targetFrameRateMs = 60)
+    unsigned int targetFrameRateMs = 60,
+    const RenderParams& params = { })
 {
     renderInternal::initRender(camera,
-        [&ff](GLFWRenderer& renderer, std::size_t frame, std::size_t time) {
-            renderer.clear();
+        [&ff, clearEachFrame = params.clearEachFrame](
+            GLFWRenderer& renderer, std::size_t frame, std::size_t time) {
+            if (clearEachFrame)
+                renderer.clear();
             ff(renderer, frame, time);
         },
         efu,
         keyHandlers,
         mouseHandler,
         windowResolution,
-        targetFrameRateMs
+        targetFrameRateMs,
+        params
     );
 }
 
@@ -119,17 +205,30 @@ void initEachPixelRender(
     const std::vector<std::pair<std::vector<int>, std::function<void()>>>& keyHandlers = { },
     const std::function<void(double, double)>& mouseHandler = { },
     utils::Vec<int, 2> windowResolution = utils::Vec<int, 2>{-1, -1},
-    unsigned int targetFrameRateMs = 60)
+    unsigned int targetFrameRateMs = 60,
+    const RenderParams& params = { })
 {
+    utils::ThreadPool pool(params.threadCount);
+    ProgressiveState<NumericT> progressive(params.progressive);
+    // refinement keeps earlier passes in the framebuffer, which the
+    // threaded loop swaps out every frame
+    const bool refine = params.progressive.enabled && !params.threadedRender;
+
     renderInternal::initRender(camera,
-        [&camera, &sf](GLFWRenderer& renderer, std::size_t frame, const std::size_t time) {
-            render(renderer, sc::makeViewFromCamera(camera), frame, time, sf);
+        [&camera, &sf, &pool, &params, &progressive, refine](
+            GLFWRenderer& renderer, std::size_t frame, const std::size_t time) {
+            const auto view = sc::makeViewFromCamera(camera, renderer.getRenderWidth(), renderer.getRenderHeight());
+            if (refine)
+                renderProgressive(renderer, view, frame, time, sf, pool, params, progressive);
+            else
+                render(renderer, view, frame, time, sf, pool, params);
         },
         efu,
         keyHandlers,
         mouseHandler,
         windowResolution,
-        targetFrameRateMs
+        targetFrameRateMs,
+        params
     );
 }
 
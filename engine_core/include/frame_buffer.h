@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "render_params.h"
+#include "utils/pixel_fill.h"
+#include "utils/tone_mapping.h"
+#include "utils/vec.h"
+
+namespace sc
+{
+
+/// Direct access to a block of 8-bit pixels. Pixel (x, y) relative to
+/// origin lives at origin + y * rowStride + x * pixelStride; rowStride is
+/// negative for bottom-up storage.
+struct PixelView
+{
+    unsigned char* origin;
+    std::ptrdiff_t rowStride;
+    std::size_t pixelStride;
+
+    unsigned char* at(std::size_t x, std::size_t y) const
+    {
+        return origin + static_cast<std::ptrdiff_t>(y) * rowStride + x * pixelStride;
+    }
+};
+
+/// Same as PixelView for the linear RGBX float buffer of HDR framebuffers.
+struct HdrPixelView
+{
+    float* origin;
+    std::ptrdiff_t rowStride;
+
+    float* at(std::size_t x, std::size_t y) const
+    {
+        return origin + static_cast<std::ptrdiff_t>(y) * rowStride + x * 4;
+    }
+};
+
+/// CPU-side 8-bit render target shared by every renderer backend.
+/// Rows are stored bottom-up so the buffer can be uploaded to GL as is,
+/// unless FrameBufferParams::topDown asks for image order. Pixels are
+/// packed RGB8 unless FrameBufferParams::pixelFormat selects a 4-byte layout.
+///
+/// In HDR mode setPixel only stores raw linear floats (top-down, RGBX) and
+/// the 8-bit buffer is produced by resolve(), which backends call right
+/// before presenting.
+///
+/// The construction size is the capacity: resize() changes the render
+/// size within it without reallocating. Rows are always packed at the
+/// current width, so pixels of the current frame are the first
+/// width * height ones of every buffer.
+class FrameBuffer
+{
+public:
+    FrameBuffer(int renderResX, int renderResY, const FrameBufferParams& params = { })
+        : _renderWidth(renderResX)
+        , _renderHeight(renderResY)
+        , _capacityWidth(renderResX)
+        , _capacityHeight(renderResY)
+        , _pixelStride(params.pixelFormat == PixelFormat::RGB8 ? 3 : 4)
+        , _redOffset(params.pixelFormat == PixelFormat::BGRA8 ? 2 : 0)
+        , _buffer(static_cast<std::size_t>(renderResX) * renderResY * _pixelStride, 0)
+        , _params(params)
+    {
+        if (_params.hdr)
+        {
+            _hdrBuffer.assign(_renderWidth * _renderHeight * 4, 0.f);
+            if (_params.gamma != 1.f)
+            {
+                _gammaLut = std::make_unique<utils::internal::GammaLut>();
+                utils::internal::buildGammaLut(*_gammaLut, _params.gamma);
+            }
+        }
+    }
+
+    FrameBuffer(FrameBuffer&&) noexcept = default;
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(FrameBuffer&&) = delete;
+
+    void setPixel(std::size_t x,
+                  std::size_t y,
+                  const utils::Vec<float, 3>& color)
+    {
+        assert(x < _renderWidth && y < _renderHeight);
+
+        if (_params.hdr)
+        {
+            float* dst = &_hdrBuffer[(y * _renderWidth + x) * 4];
+            dst[0] = color[0];
+            dst[1] = color[1];
+            dst[2] = color[2];
+            return;
+        }
+
+        storePixel(&_buffer[(storageRow(y) * _renderWidth + x) * _pixelStride], color);
+    }
+
+    /// Writes @p count pixels starting at (x, y) towards +x.
+    void writeSpan(std::size_t x,
+                   std::size_t y,
+                   const utils::Vec<float, 3>* colors,
+                   std::size_t count)
+    {
+        assert(x + count <= _renderWidth && y < _renderHeight);
+
+        if (_params.hdr)
+        {
+            float* dst = &_hdrBuffer[(y * _renderWidth + x) * 4];
+            for (std::size_t i = 0; i < count; ++i, dst += 4)
+            {
+                dst[0] = colors[i][0];
+                dst[1] = colors[i][1];
+                dst[2] = colors[i][2];
+            }
+            return;
+        }
+
+        unsigned char* dst = &_buffer[(storageRow(y) * _renderWidth + x) * _pixelStride];
+        for (std::size_t i = 0; i < count; ++i, dst += _pixelStride)
+            storePixel(dst, colors[i]);
+    }
+
+    /// Copies a @p width x @p height block of colors to (x0, y0).
+    /// @p srcStride is the distance between source rows, in pixels.
+    void blitTile(std::size_t x0,
+                  std::size_t y0,
+                  std::size_t width,
+                  std::size_t height,
+                  const utils::Vec<float, 3>* src,
+                  std::size_t srcStride)
+    {
+        for (std::size_t row = 0; row < height; ++row)
+            writeSpan(x0, y0 + row, src + row * srcStride, width);
+    }
+
+    /// 8-bit pixels of the block whose top-left corner is (x0, y0).
+    /// Writes through the view bypass clamping and HDR storage.
+    [[nodiscard]] PixelView tileView(std::size_t x0, std::size_t y0)
+    {
+        const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(_renderWidth * _pixelStride);
+        return {
+            &_buffer[(storageRow(y0) * _renderWidth + x0) * _pixelStride],
+            _params.topDown ? stride : -stride,
+            _pixelStride
+        };
+    }
+
+    /// Linear float pixels of the block at (x0, y0); HDR framebuffers only.
+    [[nodiscard]] HdrPixelView hdrTileView(std::size_t x0, std::size_t y0)
+    {
+        assert(_params.hdr);
+        return {
+            &_hdrBuffer[(y0 * _renderWidth + x0) * 4],
+            static_cast<std::ptrdiff_t>(_renderWidth * 4)
+        };
+    }
+
+    void clear(const utils::Vec<float, 3>& color = utils::Vec<float, 3>{0.f, 0.f, 0.f})
+    {
+        const std::size_t pixels = _renderWidth * _renderHeight;
+
+        if (_params.hdr)
+        {
+            utils::internal::fillPixelsF4(_hdrBuffer.data(), pixels, color[0], color[1], color[2]);
+            return;
+        }
+
+        unsigned char px[4];
+        quantize(color, px);
+        if (_pixelStride == 3)
+        {
+            utils::internal::fillPixels3(_buffer.data(), pixels, px[0], px[1], px[2]);
+            return;
+        }
+
+        // the padding byte is free to follow a gray color, which keeps
+        // gray clears on the memset path
+        if (px[0] == px[1] && px[1] == px[2])
+            px[3] = px[0];
+        utils::internal::fillPixels4(_buffer.data(), pixels, px);
+    }
+
+    [[nodiscard]] std::size_t getRenderWidth() const
+    {
+        return _renderWidth;
+    }
+
+    [[nodiscard]] std::size_t getRenderHeight() const
+    {
+        return _renderHeight;
+    }
+
+    [[nodiscard]] std::size_t capacityWidth() const { return _capacityWidth; }
+    [[nodiscard]] std::size_t capacityHeight() const { return _capacityHeight; }
+
+    /// Tone maps, gamma corrects and quantizes the HDR buffer into the
+    /// 8-bit buffer. No-op for plain RGB8 framebuffers.
+    void resolve()
+    {
+        if (!_params.hdr)
+            return;
+
+        for (std::size_t y = 0; y < _renderHeight; ++y)
+        {
+            utils::internal::quantizeRow(
+                &_hdrBuffer[y * _renderWidth * 4],
+                &_buffer[storageRow(y) * _renderWidth * _pixelStride],
+                _renderWidth,
+                _params.exposure,
+                _params.toneMapping,
+                _gammaLut.get(),
+                _pixelStride,
+                _params.pixelFormat == PixelFormat::BGRA8);
+        }
+    }
+
+    /// Sets the render size, at most the capacity. Pixel contents are
+    /// undefined afterwards.
+    void resize(std::size_t width, std::size_t height)
+    {
+        assert(width > 0 && height > 0);
+        assert(width <= _capacityWidth && height <= _capacityHeight);
+        _renderWidth = width;
+        _renderHeight = height;
+    }
+
+    /// Exchanges pixel storage and render size with a framebuffer of
+    /// identical capacity and params; used to hand whole frames between
+    /// threads without copying.
+    void swapContents(FrameBuffer& other) noexcept
+    {
+        assert(_capacityWidth == other._capacityWidth && _capacityHeight == other._capacityHeight);
+        assert(_pixelStride == other._pixelStride && _params.hdr == other._params.hdr);
+        _buffer.swap(other._buffer);
+        _hdrBuffer.swap(other._hdrBuffer);
+        std::swap(_renderWidth, other._renderWidth);
+        std::swap(_renderHeight, other._renderHeight);
+    }
+
+    /// Copies the pixels of a framebuffer of identical render size and
+    /// params.
+    void copyContents(const FrameBuffer& other)
+    {
+        assert(_renderWidth == other._renderWidth && _renderHeight == other._renderHeight);
+        assert(_pixelStride == other._pixelStride && _params.hdr == other._params.hdr);
+        const std::size_t pixels = _renderWidth * _renderHeight;
+        std::copy_n(other._buffer.begin(), pixels * _pixelStride, _buffer.begin());
+        if (_params.hdr)
+            std::copy_n(other._hdrBuffer.begin(), pixels * 4, _hdrBuffer.begin());
+    }
+
+    [[nodiscard]] const FrameBufferParams& params() const { return _params; }
+    [[nodiscard]] bool isHdr() const { return _params.hdr; }
+    [[nodiscard]] bool isTopDown() const { return _params.topDown; }
+    [[nodiscard]] PixelFormat pixelFormat() const { return _params.pixelFormat; }
+    /// Bytes per pixel of getBuffer(): 3 for RGB8, 4 otherwise.
+    [[nodiscard]] std::size_t pixelStride() const { return _pixelStride; }
+
+    /// 8-bit pixels in pixelFormat(), bottom-up unless isTopDown(), sized
+    /// for the capacity. In HDR mode it holds the last resolve() result.
+    const std::vector<unsigned char>& getBuffer() const { return _buffer; }
+    const unsigned char* getBufferPtr() const { return _buffer.data(); }
+
+    /// Linear top-down RGBX floats, empty unless the buffer is HDR.
+    const std::vector<float>& getHdrBuffer() const { return _hdrBuffer; }
+
+protected:
+    [[nodiscard]] std::size_t storageRow(std::size_t y) const
+    {
+        return _params.topDown ? y : _renderHeight - 1 - y;
+    }
+
+    /// Clamped, truncated bytes of @p color in storage order, padding 255.
+    void quantize(const utils::Vec<float, 3>& color, unsigned char (&px)[4]) const
+    {
+        px[_redOffset] =
+            static_cast<unsigned char>(std::clamp(color[0], 0.f, 1.f) * 255.f);
+        px[1] =
+            static_cast<unsigned char>(std::clamp(color[1], 0.f, 1.f) * 255.f);
+        px[2 - _redOffset] =
+            static_cast<unsigned char>(std::clamp(color[2], 0.f, 1.f) * 255.f);
+        px[3] = 255;
+    }
+
+    void storePixel(unsigned char* dst, const utils::Vec<float, 3>& color) const
+    {
+        unsigned char px[4];
+        quantize(color, px);
+        std::memcpy(dst, px, _pixelStride);
+    }
+
+    std::size_t _renderWidth;
+    std::size_t _renderHeight;
+    std::size_t _capacityWidth;
+    std::size_t _capacityHeight;
+    std::size_t _pixelStride;
+    std::size_t _redOffset;
+
+    std::vector<unsigned char> _buffer;
+
+    FrameBufferParams _params;
+    std::vector<float> _hdrBuffer;
+    std::unique_ptr<utils::internal::GammaLut> _gammaLut;
+};
+
+} // namespace sc
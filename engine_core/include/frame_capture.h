@@ -0,0 +1,404 @@
+#pragma once
+
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// stb_image_write: compiled with internal linkage into every translation
+// unit that includes this header, so it needs no dedicated .cpp file. The
+// encoders this header does not call would warn in each of those units.
+#ifndef STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#endif
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4505) // unreferenced function with internal linkage
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+#include "thirdparty/stb_image_write.h"
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace sc
+{
+
+enum class CaptureFormat
+{
+    Png,        ///< one PNG file per frame
+    Ppm,        ///< one binary PPM file per frame
+    PpmStream,  ///< binary PPM frames appended to one file, e.g. for ffmpeg -f image2pipe
+    Y4m,        ///< YUV4MPEG2 4:4:4 video stream
+};
+
+/// What FrameCapture::capture() does when every buffer is in use.
+enum class CaptureOverflow
+{
+    DropNewest,  ///< skip the frame being captured
+    DropOldest,  ///< replace the oldest frame still waiting for an encoder
+    Block,       ///< wait for an encoder; loses no frames, may stall rendering
+};
+
+struct CaptureParams
+{
+    CaptureFormat format = CaptureFormat::Png;
+    /// Sequences: file name prefix, completed by a zero-padded frame
+    /// number and the extension. Streams: the output file.
+    std::string path = "frame_";
+    /// Frames that may wait for an encoder before overflow applies.
+    std::size_t queueDepth = 4;
+    /// Encoder threads of the sequence formats. Streams always use one, so
+    /// frames are written in order.
+    std::size_t encoderThreads = 2;
+    CaptureOverflow overflow = CaptureOverflow::DropNewest;
+    /// Frame rate written to the Y4M header.
+    unsigned int fps = 60;
+};
+
+namespace internal
+{
+
+/// One captured frame: a copy of the FrameBuffer storage plus its layout.
+struct CapturedFrame
+{
+    std::vector<unsigned char> pixels;
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t pixelStride = 3;
+    bool bgra = false;
+    bool topDown = false;
+    std::size_t index = 0;
+};
+
+/// Top-down RGB8 rows of @p frame.
+inline const unsigned char* toRgbRows(const CapturedFrame& frame, std::vector<unsigned char>& scratch)
+{
+    if (frame.pixelStride == 3 && frame.topDown)
+        return frame.pixels.data();
+
+    const std::size_t rowBytes = frame.width * frame.pixelStride;
+    const std::size_t redOffset = frame.bgra ? 2 : 0;
+    scratch.resize(frame.width * frame.height * 3);
+
+    for (std::size_t y = 0; y < frame.height; ++y)
+    {
+        const std::size_t srcRow = frame.topDown ? y : frame.height - 1 - y;
+        const unsigned char* src = frame.pixels.data() + srcRow * rowBytes;
+        unsigned char* dst = scratch.data() + y * frame.width * 3;
+        for (std::size_t x = 0; x < frame.width; ++x, src += frame.pixelStride, dst += 3)
+        {
+            dst[0] = src[redOffset];
+            dst[1] = src[1];
+            dst[2] = src[2 - redOffset];
+        }
+    }
+    return scratch.data();
+}
+
+inline void writePpm(std::ostream& os, const unsigned char* rgb, std::size_t width, std::size_t height)
+{
+    os << "P6\n" << width << ' ' << height << "\n255\n";
+    os.write(reinterpret_cast<const char*>(rgb), static_cast<std::streamsize>(width * height * 3));
+}
+
+/// One 4:4:4 frame in limited-range BT.601, as most players expect.
+inline void writeY4mFrame(std::ostream& os, const unsigned char* rgb, std::size_t width, std::size_t height,
+                          std::vector<unsigned char>& planes)
+{
+    const std::size_t pixels = width * height;
+    planes.resize(pixels * 3);
+    unsigned char* yPlane = planes.data();
+    unsigned char* uPlane = yPlane + pixels;
+    unsigned char* vPlane = uPlane + pixels;
+
+    for (std::size_t i = 0; i < pixels; ++i, rgb += 3)
+    {
+        const int r = rgb[0];
+        const int g = rgb[1];
+        const int b = rgb[2];
+        yPlane[i] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        uPlane[i] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        vPlane[i] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    os << "FRAME\n";
+    os.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+}
+
+} // namespace internal
+
+/// Records presented frames without stalling the render loop.
+///
+/// capture() copies the resolved 8-bit frame into a recycled buffer and
+/// queues it; encoder threads convert and write it in the background. The
+/// pool holds queueDepth + encoderThreads buffers, so memory stays bounded
+/// and, once warmed up, capturing allocates nothing. When all buffers are
+/// in use the overflow policy decides between dropping and waiting.
+class FrameCapture
+{
+public:
+    struct Stats
+    {
+        std::size_t captured = 0;  ///< frames queued by capture()
+        std::size_t dropped = 0;   ///< frames lost to the overflow policy
+        std::size_t written = 0;   ///< frames encoded successfully
+        std::size_t failed = 0;    ///< frames the encoder could not write
+    };
+
+    explicit FrameCapture(const CaptureParams& params = { })
+        : _params(params)
+    {
+        const bool stream = isStream();
+        const std::size_t encoders = stream ? 1 : std::max<std::size_t>(_params.encoderThreads, 1);
+        const std::size_t buffers = std::max<std::size_t>(_params.queueDepth, 1) + encoders;
+
+        _frames.reserve(buffers);
+        for (std::size_t i = 0; i < buffers; ++i)
+        {
+            _frames.push_back(std::make_unique<internal::CapturedFrame>());
+            _free.push_back(_frames.back().get());
+        }
+
+        if (stream)
+            _stream.open(_params.path, std::ios::binary | std::ios::trunc);
+
+        _encoders.reserve(encoders);
+        for (std::size_t i = 0; i < encoders; ++i)
+            _encoders.emplace_back([this] { encodeLoop(); });
+    }
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    ~FrameCapture() { close(); }
+
+    /// Queues a copy of the resolved 8-bit content of @p frame. Returns
+    /// false when the frame was dropped or the capture is closed.
+    bool capture(const FrameBuffer& frame)
+    {
+        return capture(frame, _params.overflow);
+    }
+
+    /// capture() with another overflow policy for this frame, e.g. Block
+    /// from an offline loop that must not lose frames.
+    bool capture(const FrameBuffer& frame, CaptureOverflow overflow)
+    {
+        internal::CapturedFrame* slot = nullptr;
+        {
+            std::unique_lock lock(_mutex);
+            if (_closed)
+                return false;
+
+            if (_free.empty())
+            {
+                switch (overflow)
+                {
+                case CaptureOverflow::DropNewest:
+                    ++_stats.dropped;
+                    ++_nextIndex;
+                    return false;
+                case CaptureOverflow::DropOldest:
+                    if (_queued.empty())
+                    {
+                        // every buffer is being encoded
+                        ++_stats.dropped;
+                        ++_nextIndex;
+                        return false;
+                    }
+                    ++_stats.dropped;
+                    --_stats.captured;
+                    _free.push_back(_queued.front());
+                    _queued.pop_front();
+                    break;
+                case CaptureOverflow::Block:
+                    _cv.wait(lock, [this] { return !_free.empty() || _closed; });
+                    if (_closed)
+                        return false;
+                    break;
+                }
+            }
+
+            slot = _free.back();
+            _free.pop_back();
+            slot->index = _nextIndex++;
+        }
+
+        // the copy runs unlocked; the slot belongs to this thread until queued
+        const auto& buffer = frame.getBuffer();
+        const std::size_t bytes = frame.getRenderWidth() * frame.getRenderHeight() * frame.pixelStride();
+        slot->pixels.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(bytes));
+        slot->width = frame.getRenderWidth();
+        slot->height = frame.getRenderHeight();
+        slot->pixelStride = frame.pixelStride();
+        slot->bgra = frame.pixelFormat() == PixelFormat::BGRA8;
+        slot->topDown = frame.isTopDown();
+
+        {
+            std::lock_guard lock(_mutex);
+            _queued.push_back(slot);
+            ++_stats.captured;
+        }
+        _cv.notify_all();
+        return true;
+    }
+
+    /// Waits until every queued frame is written.
+    void flush()
+    {
+        std::unique_lock lock(_mutex);
+        _cv.wait(lock, [this] { return _queued.empty() && _encoding == 0; });
+        if (_stream.is_open())
+            _stream.flush();
+    }
+
+    /// Writes the remaining frames and stops the encoders. capture()
+    /// returns false afterwards.
+    void close()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            if (_closed)
+                return;
+            _closed = true;
+        }
+        _cv.notify_all();
+
+        for (auto& encoder : _encoders)
+            encoder.join();
+        _encoders.clear();
+
+        if (_stream.is_open())
+            _stream.close();
+    }
+
+    [[nodiscard]] Stats stats() const
+    {
+        std::lock_guard lock(_mutex);
+        return _stats;
+    }
+
+    [[nodiscard]] const CaptureParams& params() const { return _params; }
+
+private:
+    CaptureParams _params;
+
+    std::vector<std::unique_ptr<internal::CapturedFrame>> _frames;
+    std::vector<internal::CapturedFrame*> _free;
+    std::deque<internal::CapturedFrame*> _queued;
+    std::size_t _encoding = 0;
+    std::size_t _nextIndex = 0;
+    bool _closed = false;
+    Stats _stats;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::vector<std::thread> _encoders;
+
+    // stream state, touched only by the single stream encoder
+    std::ofstream _stream;
+    std::size_t _streamWidth = 0;
+    std::size_t _streamHeight = 0;
+
+    [[nodiscard]] bool isStream() const
+    {
+        return _params.format == CaptureFormat::PpmStream || _params.format == CaptureFormat::Y4m;
+    }
+
+    void encodeLoop()
+    {
+        std::vector<unsigned char> rgbScratch;
+        std::vector<unsigned char> planes;
+
+        for (;;)
+        {
+            internal::CapturedFrame* slot = nullptr;
+            {
+                std::unique_lock lock(_mutex);
+                // queued frames are still written after close()
+                _cv.wait(lock, [this] { return !_queued.empty() || _closed; });
+                if (_queued.empty())
+                    return;
+                slot = _queued.front();
+                _queued.pop_front();
+                ++_encoding;
+            }
+
+            const bool ok = encode(*slot, rgbScratch, planes);
+
+            {
+                std::lock_guard lock(_mutex);
+                --_encoding;
+                ++(ok ? _stats.written : _stats.failed);
+                _free.push_back(slot);
+            }
+            _cv.notify_all();
+        }
+    }
+
+    bool encode(const internal::CapturedFrame& frame,
+                std::vector<unsigned char>& rgbScratch,
+                std::vector<unsigned char>& planes)
+    {
+        if (frame.width == 0 || frame.height == 0)
+            return false;
+
+        const unsigned char* rgb = internal::toRgbRows(frame, rgbScratch);
+
+        switch (_params.format)
+        {
+        case CaptureFormat::Png:
+            return stbi_write_png(sequencePath(frame.index, ".png").c_str(),
+                                  static_cast<int>(frame.width), static_cast<int>(frame.height),
+                                  3, rgb, static_cast<int>(frame.width * 3)) != 0;
+        case CaptureFormat::Ppm:
+        {
+            std::ofstream file(sequencePath(frame.index, ".ppm"), std::ios::binary | std::ios::trunc);
+            internal::writePpm(file, rgb, frame.width, frame.height);
+            return static_cast<bool>(file);
+        }
+        case CaptureFormat::PpmStream:
+            internal::writePpm(_stream, rgb, frame.width, frame.height);
+            return static_cast<bool>(_stream);
+        case CaptureFormat::Y4m:
+            if (_streamWidth == 0)
+            {
+                _streamWidth = frame.width;
+                _streamHeight = frame.height;
+                _stream << "YUV4MPEG2 W" << frame.width << " H" << frame.height
+                        << " F" << _params.fps << ":1 Ip A1:1 C444\n";
+            }
+            // a Y4M stream cannot change its frame size
+            if (frame.width != _streamWidth || frame.height != _streamHeight)
+                return false;
+            internal::writeY4mFrame(_stream, rgb, frame.width, frame.height, planes);
+            return static_cast<bool>(_stream);
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::string sequencePath(std::size_t index, const char* extension) const
+    {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%06zu", index);
+        return _params.path + number + extension;
+    }
+};
+
+} // namespace sc
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "frame_buffer.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace sc::internal
+{
+
+/// Hands finished frames from a render thread to the presenting thread by
+/// swapping FrameBuffer storage, so no pixels are copied.
+///
+/// With 2 buffers publish() blocks until the previous frame was taken, the
+/// render thread runs at most one frame ahead and no frame is dropped.
+/// With 3 buffers a spare slot holds the newest finished frame, publish()
+/// never blocks and frames the presenter did not pick up are replaced.
+class FrameExchange
+{
+public:
+    FrameExchange(const FrameBuffer& like, std::size_t bufferCount)
+    {
+        if (bufferCount >= 3)
+        {
+            _ready = std::make_unique<FrameBuffer>(
+                static_cast<int>(like.getRenderWidth()),
+                static_cast<int>(like.getRenderHeight()),
+                like.params());
+        }
+    }
+
+    /// Render thread: gives the frame in @p back away. @p back receives
+    /// storage with stale contents in return.
+    void publish(FrameBuffer& back)
+    {
+        std::unique_lock lock(_mutex);
+
+        if (_ready)
+        {
+            _ready->swapContents(back);
+            _pending = true;
+            _cv.notify_all();
+            return;
+        }
+
+        _back = &back;
+        _pending = true;
+        _cv.notify_all();
+        _cv.wait(lock, [this] { return !_pending || _closed; });
+        _back = nullptr;
+    }
+
+    /// Presenting thread: moves the newest frame into @p front, waiting at
+    /// most @p timeout for one. Returns false when no new frame arrived.
+    template<typename Duration>
+    bool acquire(FrameBuffer& front, Duration timeout)
+    {
+        std::unique_lock lock(_mutex);
+        if (!_cv.wait_for(lock, timeout, [this] { return _pending || _closed; })
+            || !_pending)
+        {
+            return false;
+        }
+
+        front.swapContents(_ready ? *_ready : *_back);
+        _pending = false;
+        _cv.notify_all();
+        return true;
+    }
+
+    /// Releases a render thread blocked in publish().
+    void close()
+    {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+        _cv.notify_all();
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::unique_ptr<FrameBuffer> _ready;
+    FrameBuffer* _back = nullptr;
+    bool _pending = false;
+    bool _closed = false;
+};
+
+} // namespace sc::internal
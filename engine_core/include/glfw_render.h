@@ -3,15 +3,29 @@
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <stdexcept>
 #include <unordered_set>
 
+#include "frame_buffer.h"
+#include "render_params.h"
+#include "utils/spsc_queue.h"
 #include "utils/vec.h"
 
+// Windows ships the GL 1.1 <GL/gl.h>, which predates the BGRA upload path.
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+#ifndef GL_UNSIGNED_INT_8_8_8_8_REV
+#define GL_UNSIGNED_INT_8_8_8_8_REV 0x8367
+#endif
+
 namespace sc
 {
 namespace internal
@@ -26,13 +40,124 @@ struct KeyComboHash
         return h;
     }
 };
+
+#ifdef APIENTRY
+#define SC_GL_APIENTRY APIENTRY
+#else
+#define SC_GL_APIENTRY
+#endif
+
+/// GL 2.1 pixel-buffer-object entry points, resolved at runtime through
+/// glfwGetProcAddress so no extension loader is needed.
+struct PixelBufferApi
+{
+    static constexpr GLenum PIXEL_UNPACK_BUFFER = 0x88EC;
+    static constexpr GLenum STREAM_DRAW = 0x88E0;
+    static constexpr GLenum WRITE_ONLY = 0x88B9;
+
+    using GenBuffers = void (SC_GL_APIENTRY*)(GLsizei, GLuint*);
+    using DeleteBuffers = void (SC_GL_APIENTRY*)(GLsizei, const GLuint*);
+    using BindBuffer = void (SC_GL_APIENTRY*)(GLenum, GLuint);
+    using BufferData = void (SC_GL_APIENTRY*)(GLenum, std::ptrdiff_t, const void*, GLenum);
+    using MapBuffer = void* (SC_GL_APIENTRY*)(GLenum, GLenum);
+    using UnmapBuffer = GLboolean (SC_GL_APIENTRY*)(GLenum);
+
+    GenBuffers genBuffers = nullptr;
+    DeleteBuffers deleteBuffers = nullptr;
+    BindBuffer bindBuffer = nullptr;
+    BufferData bufferData = nullptr;
+    MapBuffer mapBuffer = nullptr;
+    UnmapBuffer unmapBuffer = nullptr;
+
+    /// Requires a current context. Returns false if any entry point is missing.
+    bool load()
+    {
+        genBuffers = reinterpret_cast<GenBuffers>(glfwGetProcAddress("glGenBuffers"));
+        deleteBuffers = reinterpret_cast<DeleteBuffers>(glfwGetProcAddress("glDeleteBuffers"));
+        bindBuffer = reinterpret_cast<BindBuffer>(glfwGetProcAddress("glBindBuffer"));
+        bufferData = reinterpret_cast<BufferData>(glfwGetProcAddress("glBufferData"));
+        mapBuffer = reinterpret_cast<MapBuffer>(glfwGetProcAddress("glMapBuffer"));
+        unmapBuffer = reinterpret_cast<UnmapBuffer>(glfwGetProcAddress("glUnmapBuffer"));
+        return genBuffers && deleteBuffers && bindBuffer &&
+               bufferData && mapBuffer && unmapBuffer;
+    }
+};
+
+#undef SC_GL_APIENTRY
+
+/// Converts RGB8 texels into the BGRA8 layout GL_BGRA uploads expect.
+inline void packRgbToBgra(const unsigned char* src, unsigned char* dst, std::size_t pixels)
+{
+    for (std::size_t i = 0; i < pixels; ++i)
+    {
+        dst[i * 4 + 0] = src[i * 3 + 2];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 0];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+/// How present() hands a framebuffer of a given PixelFormat to GL.
+struct TexelLayout
+{
+    GLint internalFormat;
+    GLenum format;
+    GLenum type;
+    std::size_t bytesPerPixel;
+    /// RGB8 storage that has to go through packRgbToBgra first.
+    bool packFromRgb;
+};
+
+inline TexelLayout makeTexelLayout(PixelFormat pixelFormat, UploadFormat upload)
+{
+    switch (pixelFormat)
+    {
+    case PixelFormat::RGBX8:
+        return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4, false };
+    case PixelFormat::BGRA8:
+        return { GL_RGBA8, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 4, false };
+    default:
+        if (upload == UploadFormat::BGRA8)
+            return { GL_RGBA8, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 4, true };
+        return { GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, 3, false };
+    }
+}
+
+/// Key or mouse input recorded on the event thread for queued dispatch.
+struct InputEvent
+{
+    enum class Type { Key, MouseMove };
+
+    Type type = Type::Key;
+    int key = 0;
+    int action = 0;
+    double dx = 0.0;
+    double dy = 0.0;
+};
+
+using InputQueue = utils::SpscQueue<InputEvent, 1024>;
+
 } // namespace internal
 
-class GLFWRenderer
+/// CPU time spent handing frames to GL in present().
+struct UploadStats
+{
+    double lastMs = 0.0;
+    double totalMs = 0.0;
+    std::size_t uploads = 0;
+
+    [[nodiscard]] double averageMs() const
+    {
+        return uploads ? totalMs / static_cast<double>(uploads) : 0.0;
+    }
+};
+
+class GLFWRenderer : public FrameBuffer
 {
     using KeyCombo = std::vector<int>;
     using KeyHandler = std::function<void()>;
     using MouseMoveHandler = std::function<void(double dx, double dy)>;
+    using PresentHandler = std::function<void(const FrameBuffer& frame)>;
 
     static inline int _glfwRefCount = 0;
 
@@ -40,12 +165,13 @@ public:
     GLFWRenderer(int renderResX,
                  int renderResY,
                  const utils::Vec<int, 2>& windowRes,
-                 const char* title = "Renderer")
-        : _renderWidth(renderResX)
-        , _renderHeight(renderResY)
+                 const char* title = "Renderer",
+                 const UploadParams& upload = { },
+                 const FrameBufferParams& frameBuffer = { })
+        : FrameBuffer(renderResX, renderResY, frameBuffer)
         , _windowWidth(windowRes[0])
         , _windowHeight(windowRes[1])
-        , _buffer(renderResX * renderResY * 3, 0)
+        , _upload(upload)
     {
         if (_glfwRefCount++ == 0)
         {
@@ -98,18 +224,43 @@ public:
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+        // Storage is allocated once; present() only streams texels into it.
+        const auto layout = internal::makeTexelLayout(pixelFormat(), _upload.format);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            layout.internalFormat,
+            static_cast<GLsizei>(_capacityWidth),
+            static_cast<GLsizei>(_capacityHeight),
+            0,
+            layout.format,
+            layout.type,
+            nullptr);
+
+        if (_upload.pixelBufferCount > 0 && _pbo.load())
+        {
+            _pixelBuffers.resize(_upload.pixelBufferCount, 0);
+            _pbo.genBuffers(static_cast<GLsizei>(_pixelBuffers.size()), _pixelBuffers.data());
+        }
     }
 
     GLFWRenderer(GLFWRenderer&& other) noexcept
-        : _keyHandlers(std::move(other._keyHandlers))
-        , _renderWidth(other._renderWidth)
-        , _renderHeight(other._renderHeight)
+        : FrameBuffer(std::move(other))
+        , _keyHandlers(std::move(other._keyHandlers))
         , _windowWidth(other._windowWidth)
         , _windowHeight(other._windowHeight)
-        , _buffer(std::move(other._buffer))
         , _window(std::exchange(other._window, nullptr))
         , _textureId(std::exchange(other._textureId, 0))
+        , _upload(other._upload)
+        , _pbo(other._pbo)
+        , _pixelBuffers(std::move(other._pixelBuffers))
+        , _nextPixelBuffer(other._nextPixelBuffer)
+        , _staging(std::move(other._staging))
+        , _uploadStats(other._uploadStats)
+        , _inputQueue(std::move(other._inputQueue))
         , _mouseMoveHandler(std::move(other._mouseMoveHandler))
+        , _presentHandler(std::move(other._presentHandler))
         , _lastMouseX(other._lastMouseX)
         , _lastMouseY(other._lastMouseY)
         , _firstMouse(other._firstMouse)
@@ -129,6 +280,8 @@ public:
         if (_window)
         {
             glfwMakeContextCurrent(_window);
+            if (!_pixelBuffers.empty())
+                _pbo.deleteBuffers(static_cast<GLsizei>(_pixelBuffers.size()), _pixelBuffers.data());
             if (_textureId)
                 glDeleteTextures(1, &_textureId);
             glfwDestroyWindow(_window);
@@ -144,25 +297,17 @@ public:
             glfwMakeContextCurrent(_window);
     }
 
-    void setPixel(std::size_t x,
-                  std::size_t y,
-                  const utils::Vec<float, 3>& color)
+    /// @brief Upload CPU buffer to GL texture and swap. Calls makeContextCurrent() internally.
+    void present()
     {
-        assert(x < _renderWidth && y < _renderHeight);
-
-        std::size_t idx =
-            (_renderHeight - 1 - y) * _renderWidth * 3 + x * 3;
-
-        _buffer[idx + 0] =
-            static_cast<unsigned char>(std::clamp(color[0], 0.f, 1.f) * 255.f);
-        _buffer[idx + 1] =
-            static_cast<unsigned char>(std::clamp(color[1], 0.f, 1.f) * 255.f);
-        _buffer[idx + 2] =
-            static_cast<unsigned char>(std::clamp(color[2], 0.f, 1.f) * 255.f);
+        presentFrame(*this);
     }
 
-    /// @brief Upload CPU buffer to GL texture and swap. Calls makeContextCurrent() internally.
-    void present()
+    /// present() for a frame held in another framebuffer of the same
+    /// capacity and params, e.g. the front buffer of a threaded render loop.
+    /// A frame smaller than the capacity is uploaded into the corner of the
+    /// texture and that part is stretched over the window.
+    void presentFrame(FrameBuffer& frame)
     {
         if (!_window)
             return;
@@ -174,29 +319,31 @@ public:
         glBindTexture(GL_TEXTURE_2D, _textureId);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RGB,
-            static_cast<GLsizei>(_renderWidth),
-            static_cast<GLsizei>(_renderHeight),
-            0,
-            GL_RGB,
-            GL_UNSIGNED_BYTE,
-            _buffer.data());
+        frame.resolve();
+        if (_presentHandler)
+            _presentHandler(frame);
+        upload(frame);
 
         glColor3f(1.f, 1.f, 1.f);
 
+        const float u1 = static_cast<float>(frame.getRenderWidth()) / static_cast<float>(_capacityWidth);
+        const float vMax = static_cast<float>(frame.getRenderHeight()) / static_cast<float>(_capacityHeight);
+
+        // top-down buffers are flipped here, once per frame
+        const float v0 = isTopDown() ? vMax : 0.f;
+        const float v1 = vMax - v0;
+
         glBegin(GL_QUADS);
-            glTexCoord2f(0.f, 0.f); glVertex2f(0.f, 0.f);
-            glTexCoord2f(1.f, 0.f); glVertex2f(1.f, 0.f);
-            glTexCoord2f(1.f, 1.f); glVertex2f(1.f, 1.f);
-            glTexCoord2f(0.f, 1.f); glVertex2f(0.f, 1.f);
+            glTexCoord2f(0.f, v0); glVertex2f(0.f, 0.f);
+            glTexCoord2f(u1, v0); glVertex2f(1.f, 0.f);
+            glTexCoord2f(u1, v1); glVertex2f(1.f, 1.f);
+            glTexCoord2f(0.f, v1); glVertex2f(0.f, 1.f);
         glEnd();
 
         glfwSwapBuffers(_window);
 
-        handleSinglePressedKeys();
+        if (!_inputQueue)
+            handleSinglePressedKeys();
     }
 
     /// @brief Backward-compat: present + pollEvents (single-window path).
@@ -211,16 +358,6 @@ public:
         return _window ? glfwWindowShouldClose(_window) : true;
     }
 
-    [[nodiscard]] std::size_t getRenderWidth() const
-    {
-        return _renderWidth;
-    }
-
-    [[nodiscard]] std::size_t getRenderHeight() const
-    {
-        return _renderHeight;
-    }
-
     void onKey(KeyCombo key, KeyHandler handler)
     {
         if (key.size() == 1)
@@ -236,48 +373,144 @@ public:
         _mouseMoveHandler = std::move(handler);
     }
 
-    void clear(const utils::Vec<float, 3>& color = utils::Vec<float, 3>{0.f, 0.f, 0.f})
+    /// Called with every resolved frame right before it is uploaded, on the
+    /// presenting thread, e.g. to feed a FrameCapture.
+    void onPresent(PresentHandler handler)
+    {
+        _presentHandler = std::move(handler);
+    }
+
+    [[nodiscard]] const UploadStats& uploadStats() const { return _uploadStats; }
+
+    /// Makes the GLFW callbacks only record input; handlers then run in
+    /// dispatchInput() on the thread that calls it. Events arriving while
+    /// the queue is full are dropped.
+    void queueInput()
+    {
+        if (!_inputQueue)
+            _inputQueue = std::make_unique<internal::InputQueue>();
+    }
+
+    /// Runs the handlers of all queued input plus the held-key handlers.
+    void dispatchInput()
     {
-        const unsigned char r =
-            static_cast<unsigned char>(std::clamp(color[0], 0.f, 1.f) * 255.f);
-        const unsigned char g =
-            static_cast<unsigned char>(std::clamp(color[1], 0.f, 1.f) * 255.f);
-        const unsigned char b =
-            static_cast<unsigned char>(std::clamp(color[2], 0.f, 1.f) * 255.f);
-
-        for (std::size_t i = 0; i < _buffer.size(); i += 3)
+        if (!_inputQueue)
+            return;
+
+        internal::InputEvent event;
+        while (_inputQueue->tryPop(event))
         {
-            _buffer[i + 0] = r;
-            _buffer[i + 1] = g;
-            _buffer[i + 2] = b;
+            if (event.type == internal::InputEvent::Type::Key)
+                handleKeyEvent(event.key, event.action);
+            else if (_mouseMoveHandler)
+                _mouseMoveHandler(event.dx, event.dy);
         }
-    }
 
-    const std::vector<unsigned char>& getBuffer() { return _buffer; }
-    const unsigned char* getBufferPtr() { return _buffer.data(); }
+        handleSinglePressedKeys();
+    }
 
 private:
     std::unordered_map<KeyCombo, KeyHandler, internal::KeyComboHash> _comboHandlers;
     std::unordered_map<int, KeyHandler> _keyHandlers;
 
-    std::size_t _renderWidth;
-    std::size_t _renderHeight;
     int _windowWidth;
     int _windowHeight;
 
-    std::vector<unsigned char> _buffer;
     GLFWwindow* _window = nullptr;
     unsigned int _textureId = 0;
 
+    UploadParams _upload;
+    internal::PixelBufferApi _pbo;
+    std::vector<GLuint> _pixelBuffers;
+    std::size_t _nextPixelBuffer = 0;
+    std::vector<unsigned char> _staging;
+    UploadStats _uploadStats;
+
+    std::unique_ptr<internal::InputQueue> _inputQueue;
     std::vector<int> _pressedKeys;
 
     MouseMoveHandler _mouseMoveHandler;
+    PresentHandler _presentHandler;
 
     double _lastMouseX = 0.0;
     double _lastMouseY = 0.0;
     bool _firstMouse = true;
     bool _mouseCaptured = false;
 
+    /// Streams the pixels of @p frame into the persistent texture, at its
+    /// current size. With pixel buffers the
+    /// frame is copied into the next PBO of the ring (orphaned first, so the
+    /// driver never waits for the GPU to finish reading it) and the texture
+    /// update is sourced from there asynchronously.
+    void upload(const FrameBuffer& frame)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto layout = internal::makeTexelLayout(pixelFormat(), _upload.format);
+        const bool pack = layout.packFromRgb;
+        const unsigned char* pixels = frame.getBufferPtr();
+        const std::size_t width = frame.getRenderWidth();
+        const std::size_t height = frame.getRenderHeight();
+        const std::size_t count = width * height;
+        const std::size_t bytes = count * layout.bytesPerPixel;
+
+        const void* source = pixels;
+
+        if (!_pixelBuffers.empty())
+        {
+            const GLuint pbo = _pixelBuffers[_nextPixelBuffer];
+            _nextPixelBuffer = (_nextPixelBuffer + 1) % _pixelBuffers.size();
+
+            _pbo.bindBuffer(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER, pbo);
+            _pbo.bufferData(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER,
+                            static_cast<std::ptrdiff_t>(bytes), nullptr,
+                            internal::PixelBufferApi::STREAM_DRAW);
+
+            auto* dst = static_cast<unsigned char*>(
+                _pbo.mapBuffer(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER,
+                               internal::PixelBufferApi::WRITE_ONLY));
+            if (dst)
+            {
+                if (pack)
+                    internal::packRgbToBgra(pixels, dst, count);
+                else
+                    std::copy_n(pixels, bytes, dst);
+                _pbo.unmapBuffer(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER);
+                source = nullptr;  // offset 0 into the bound PBO
+            }
+            else
+            {
+                _pbo.bindBuffer(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER, 0);
+            }
+        }
+
+        if (source && pack)
+        {
+            _staging.resize(bytes);
+            internal::packRgbToBgra(pixels, _staging.data(), count);
+            source = _staging.data();
+        }
+
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            static_cast<GLsizei>(width),
+            static_cast<GLsizei>(height),
+            layout.format,
+            layout.type,
+            source);
+
+        if (!_pixelBuffers.empty())
+            _pbo.bindBuffer(internal::PixelBufferApi::PIXEL_UNPACK_BUFFER, 0);
+
+        const auto end = std::chrono::steady_clock::now();
+        _uploadStats.lastMs = std::chrono::duration<double, std::milli>(end - start).count();
+        _uploadStats.totalMs += _uploadStats.lastMs;
+        ++_uploadStats.uploads;
+    }
+
     void handleSinglePressedKeys() {
         for (const auto key : _pressedKeys) {
             auto itKey = _keyHandlers.find(key);
@@ -297,23 +530,38 @@ private:
         if (!self || !self->_mouseCaptured)
             return;
 
+        if (self->_inputQueue)
+        {
+            internal::InputEvent event;
+            event.type = internal::InputEvent::Type::Key;
+            event.key = key;
+            event.action = action;
+            self->_inputQueue->tryPush(event);
+            return;
+        }
+
+        self->handleKeyEvent(key, action);
+    }
+
+    void handleKeyEvent(int key, int action)
+    {
         if (action == GLFW_RELEASE) {
-            self->_pressedKeys.erase(
+            _pressedKeys.erase(
                 std::remove(
-                    self->_pressedKeys.begin(),
-                    self->_pressedKeys.end(),
+                    _pressedKeys.begin(),
+                    _pressedKeys.end(),
                     key
                 ),
-                self->_pressedKeys.end()
+                _pressedKeys.end()
             );
         } if (action == GLFW_PRESS) {
-            self->_pressedKeys.push_back(key);
+            _pressedKeys.push_back(key);
         }
 
-        std::sort(self->_pressedKeys.begin(), self->_pressedKeys.end());
+        std::sort(_pressedKeys.begin(), _pressedKeys.end());
 
-        auto itCombo = self->_comboHandlers.find(self->_pressedKeys);
-        if (itCombo == self->_comboHandlers.end()) return;
+        auto itCombo = _comboHandlers.find(_pressedKeys);
+        if (itCombo == _comboHandlers.end()) return;
         itCombo->second();
     }
 
@@ -341,6 +589,16 @@ private:
         self->_lastMouseX = xpos;
         self->_lastMouseY = ypos;
 
+        if (self->_inputQueue)
+        {
+            internal::InputEvent event;
+            event.type = internal::InputEvent::Type::MouseMove;
+            event.dx = dx;
+            event.dy = dy;
+            self->_inputQueue->tryPush(event);
+            return;
+        }
+
         self->_mouseMoveHandler(dx, dy);
     }
 
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "camera/camera.h"
+#include "frame_capture.h"
+#include "offscreen_render.h"
+#include "progressive_render.h"
+#include "render.h"
+#include "render_params.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+namespace sc
+{
+
+/// Frame schedule of the offline drivers.
+struct OfflineParams
+{
+    std::size_t frameCount = 60;
+    /// Synthetic time step: frame i sees time round(i * frameTimeMs).
+    double frameTimeMs = 1000.0 / 60.0;
+    std::size_t firstFrame = 0;
+};
+
+namespace renderInternal
+{
+
+/// Offline counterpart of runMainRenderThread(): same call order, but
+/// frame times come from @p offline instead of the clock, and frames run
+/// back to back. With params.capture every frame is queued, waiting for an
+/// encoder if needed, and written before this returns.
+template<typename RenderFunction, typename EachFrameUpdate>
+void runOffline(OffscreenRenderer& renderer,
+    RenderFunction& rf,
+    EachFrameUpdate& efu,
+    const OfflineParams& offline,
+    const RenderParams& params)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto timeAt = [&offline](std::size_t frame) {
+        return static_cast<std::size_t>(std::llround(static_cast<double>(frame) * offline.frameTimeMs));
+    };
+
+    const std::size_t end = offline.firstFrame + offline.frameCount;
+    for (std::size_t frame = offline.firstFrame; frame < end; )
+    {
+        const auto start = Clock::now();
+        const std::size_t time = timeAt(frame);
+
+        SC_PROFILE_FRAME(frame);
+        rf(renderer, frame++, time);
+        {
+            SC_PROFILE_STAGE(Present);
+            renderer.present();
+            if (params.capture)
+                params.capture->capture(renderer, CaptureOverflow::Block);
+        }
+        {
+            SC_PROFILE_STAGE(Update);
+            efu(frame, time);
+        }
+
+        if (params.frameStats)
+            params.frameStats->record(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    if (params.capture)
+        params.capture->flush();
+}
+
+} // namespace renderInternal
+
+/// initPerFrameRender() without a window: renders offline.frameCount
+/// frames headless, as fast as possible, on a fixed synthetic timestep.
+/// @p ff receives an OffscreenRenderer; take it as FrameBuffer& to share
+/// one callback with the windowed entry point.
+template<typename NumericT,
+         template<typename, std::size_t> typename VecT,
+         typename FrameFunction,
+         typename EachFrameUpdate = decltype([](std::size_t, std::size_t){ })>
+void renderPerFrameOffline(
+    const Camera<NumericT, VecT>& camera,
+    FrameFunction ff,
+    EachFrameUpdate efu = { },
+    const OfflineParams& offline = { },
+    const RenderParams& params = { })
+{
+    OffscreenRenderer renderer(
+        static_cast<int>(camera.res()[0]),
+        static_cast<int>(camera.res()[1]),
+        params.frameBuffer);
+
+    auto rf = [&ff, clearEachFrame = params.clearEachFrame](
+        OffscreenRenderer& r, std::size_t frame, std::size_t time) {
+        if (clearEachFrame)
+            r.clear();
+        ff(r, frame, time);
+    };
+
+    renderInternal::runOffline(renderer, rf, efu, offline, params);
+}
+
+/// initEachPixelRender() without a window, see renderPerFrameOffline().
+/// Every pixel is shaded independently of the thread count, so equal
+/// inputs give bit-identical frames.
+template<typename NumericT,
+         template<typename, std::size_t> typename VecT,
+         typename ShadeFunction,
+         typename EachFrameUpdate = decltype([](std::size_t, std::size_t){ })>
+void renderEachPixelOffline(
+    const Camera<NumericT, VecT>& camera,
+    ShadeFunction sf,
+    EachFrameUpdate efu = { },
+    const OfflineParams& offline = { },
+    const RenderParams& params = { })
+{
+    OffscreenRenderer renderer(
+        static_cast<int>(camera.res()[0]),
+        static_cast<int>(camera.res()[1]),
+        params.frameBuffer);
+
+    utils::ThreadPool pool(params.threadCount);
+    ProgressiveState<NumericT> progressive(params.progressive);
+
+    auto rf = [&camera, &sf, &pool, &params, &progressive](
+        OffscreenRenderer& r, std::size_t frame, std::size_t time) {
+        if (params.progressive.enabled)
+            renderProgressive(r, makeViewFromCamera(camera), frame, time, sf, pool, params, progressive);
+        else
+            render(r, makeViewFromCamera(camera), frame, time, sf, pool, params);
+    };
+
+    renderInternal::runOffline(renderer, rf, efu, offline, params);
+}
+
+} // namespace sc
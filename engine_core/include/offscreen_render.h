@@ -0,0 +1,55 @@
+#pragma once
+
+#include "frame_buffer.h"
+
+#include <functional>
+#include <utility>
+
+namespace sc
+{
+
+/// Headless renderer: same pixel API as GLFWRenderer, but the frame stays
+/// in memory. Needs neither a display nor a GL context, so it works on
+/// batch nodes and in CI. Read results back with getBuffer().
+class OffscreenRenderer : public FrameBuffer
+{
+public:
+    using PresentHandler = std::function<void(const FrameBuffer& frame)>;
+
+    OffscreenRenderer(int renderResX,
+                      int renderResY,
+                      const FrameBufferParams& params = { })
+        : FrameBuffer(renderResX, renderResY, params)
+    {}
+
+    OffscreenRenderer(OffscreenRenderer&&) noexcept = default;
+
+    void makeContextCurrent() {}
+
+    /// Nothing to upload; resolves HDR content and counts finished frames.
+    void present()
+    {
+        resolve();
+        if (_presentHandler)
+            _presentHandler(*this);
+        ++_presentedFrames;
+    }
+
+    /// Called with every resolved frame, e.g. to feed a FrameCapture.
+    void onPresent(PresentHandler handler)
+    {
+        _presentHandler = std::move(handler);
+    }
+
+    void show() { present(); }
+
+    [[nodiscard]] bool shouldClose() const { return false; }
+
+    [[nodiscard]] std::size_t presentedFrames() const { return _presentedFrames; }
+
+private:
+    std::size_t _presentedFrames = 0;
+    PresentHandler _presentHandler;
+};
+
+} // namespace sc
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "camera/camera_view.h"
+#include "frame_buffer.h"
+#include "render.h"
+#include "render_params.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+#include "utils/tiling.h"
+#include "utils/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace sc
+{
+
+/// Refinement schedule of renderProgressive().
+///
+/// After the view changes, the first pass shades one pixel per
+/// startStride x startStride block and fills the block with it. Every
+/// following frame with an unchanged view halves the stride and shades only
+/// the pixels no earlier pass covered, so reaching full resolution costs
+/// one full frame of shading in total.
+template<typename NumericT>
+class ProgressiveState
+{
+public:
+    explicit ProgressiveState(const ProgressiveParams& params = { })
+        : _params(params)
+    {
+        // power of two, at most 16
+        _startStride = 1;
+        while (_startStride < 16 && _startStride * 2 <= _params.startStride)
+            _startStride *= 2;
+    }
+
+    /// Restarts refinement on the next frame, for changes the view cannot
+    /// show, e.g. scene state updated by efu.
+    void invalidate() { _valid = false; }
+
+    /// True once the current view is shaded at full resolution.
+    [[nodiscard]] bool complete() const { return _valid && _stride == 1; }
+
+    [[nodiscard]] std::size_t startStride() const { return _startStride; }
+
+    /// Stride of the pass to render for @p view, 0 when nothing is left.
+    /// @p first is set when the pass must cover the whole frame.
+    std::size_t advance(const internal::CameraView<NumericT>& view, bool& first)
+    {
+        const bool changed = !_valid
+            || !sameView(view)
+            || (_params.changed && _params.changed());
+
+        _view = view;
+        _valid = true;
+
+        if (changed)
+        {
+            _stride = _startStride;
+            first = true;
+            return _stride;
+        }
+
+        first = false;
+        if (_stride == 1)
+            return 0;
+        _stride /= 2;
+        return _stride;
+    }
+
+private:
+    ProgressiveParams _params;
+    std::size_t _startStride;
+    std::size_t _stride = 0;
+    bool _valid = false;
+    internal::CameraView<NumericT> _view;
+
+    bool sameView(const internal::CameraView<NumericT>& view) const
+    {
+        auto same = [](const auto& a, const auto& b) {
+            return std::equal(a.begin(), a.end(), b.begin());
+        };
+        return view.width == _view.width && view.height == _view.height
+            && same(view.origin, _view.origin)
+            && same(view.pixelOrigin, _view.pixelOrigin)
+            && same(view.stepX, _view.stepX)
+            && same(view.stepY, _view.stepY);
+    }
+};
+
+/// Tile-parallel render() that refines over several frames while the view
+/// stays still. Pixels of earlier passes are kept in @p renderer, so it
+/// must hold the previous frame, i.e. it must not be cleared or swapped
+/// between calls. ShadeFunction is treated as time-invariant for a fixed
+/// view; use ProgressiveState::invalidate() or ProgressiveParams::changed
+/// when it is not.
+template<typename NumericT, typename ShadeFunction>
+inline void renderProgressive(
+    FrameBuffer& renderer,
+    const internal::CameraView<NumericT>& cameraView,
+    std::size_t frame,
+    std::size_t timeMs,
+    ShadeFunction sf,
+    utils::ThreadPool& pool,
+    const RenderParams& params,
+    ProgressiveState<NumericT>& state
+)
+{
+    bool first = false;
+    const std::size_t stride = state.advance(cameraView, first);
+    if (stride == 0)
+        return;
+
+    SC_PROFILE_STAGE(Shade);
+
+    // tiles are aligned to the coarsest stride so no block crosses a tile
+    const std::size_t align = state.startStride();
+    const std::size_t tileSize =
+        (std::max<std::size_t>(params.tileSize, 1) + align - 1) / align * align;
+    const std::size_t width = cameraView.width;
+    const std::size_t height = cameraView.height;
+    const std::size_t tilesX = (width + tileSize - 1) / tileSize;
+    const std::size_t tilesY = (height + tileSize - 1) / tileSize;
+
+    const auto tiles = utils::makeTileOrder(tilesX, tilesY, params.tileOrder);
+    const std::size_t coarser = stride * 2;
+
+    std::vector<std::vector<utils::Vec<float, 3>>> scratch(
+        pool.size(), std::vector<utils::Vec<float, 3>>(tileSize));
+
+    pool.parallelFor(tiles.size(), [&](std::size_t i, std::size_t slot)
+    {
+        const std::size_t tile = tiles[i];
+        const std::size_t x0 = (tile % tilesX) * tileSize;
+        const std::size_t y0 = (tile / tilesX) * tileSize;
+        const std::size_t x1 = std::min(x0 + tileSize, width);
+        const std::size_t y1 = std::min(y0 + tileSize, height);
+        utils::Vec<float, 3>* samples = scratch[slot].data();
+
+        std::array<utils::Vec<float, 3>, 16> run;
+
+        for (std::size_t y = y0; y < y1; y += stride)
+        {
+            // on refinement passes, even rows of the coarser grid already
+            // hold their even columns
+            const bool coarseRow = !first && y % coarser == 0;
+            const std::size_t xs = coarseRow ? x0 + stride : x0;
+            const std::size_t step = coarseRow ? coarser : stride;
+            if (xs >= x1)
+                continue;
+
+            const std::size_t count = (x1 - xs + step - 1) / step;
+            internal::shadeRow(cameraView, xs, y, count, step, sf, frame, timeMs,
+                               params.packetWidth, samples);
+
+            const std::size_t blockH = std::min(stride, y1 - y);
+            for (std::size_t s = 0; s < count; ++s)
+            {
+                const std::size_t x = xs + s * step;
+                const std::size_t blockW = std::min(stride, x1 - x);
+                run.fill(samples[s]);
+                for (std::size_t row = 0; row < blockH; ++row)
+                    renderer.writeSpan(x, y + row, run.data(), blockW);
+            }
+        }
+    });
+}
+
+} // namespace sc
@@ -1,26 +1,192 @@
 #pragma once
 
 #include "camera/camera_view.h"
+#include "camera/ray_packet.h"
 #include "utils/vec.h"
-#include "glfw_render.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+#include "utils/tiling.h"
+#include "frame_buffer.h"
+#include "render_params.h"
+
+#include <type_traits>
+#include <vector>
 
 namespace sc
 {
 
+/// Shade function taking a whole packet:
+/// void(const RayPacket<NumericT, N>&, std::size_t frame, std::size_t timeMs, ColorPacket<N>&).
+/// The render functions detect it and call it instead of per-pixel shading.
+template<typename F, typename NumericT, std::size_t N>
+concept PacketShadeFunction = requires(F& f,
+                                       const RayPacket<NumericT, N>& rays,
+                                       ColorPacket<N>& colors,
+                                       std::size_t n)
+{
+    f(rays, n, n, colors);
+};
+
+template<typename F, typename NumericT>
+constexpr bool isPacketShadeFunction =
+    PacketShadeFunction<F, NumericT, 4>
+    || PacketShadeFunction<F, NumericT, 8>
+    || PacketShadeFunction<F, NumericT, 16>;
+
+namespace internal
+{
+
+/// Calls @p fn with the packet width to use for @p F: @p preferred when
+/// the shader accepts it, otherwise the widest one it accepts.
+template<typename F, typename NumericT, typename Fn>
+inline void withPacketWidth(std::size_t preferred, Fn&& fn)
+{
+    using W4 = std::integral_constant<std::size_t, 4>;
+    using W8 = std::integral_constant<std::size_t, 8>;
+    using W16 = std::integral_constant<std::size_t, 16>;
+
+    if constexpr (PacketShadeFunction<F, NumericT, 16>)
+        if (preferred == 16) return fn(W16{ });
+    if constexpr (PacketShadeFunction<F, NumericT, 8>)
+        if (preferred == 8) return fn(W8{ });
+    if constexpr (PacketShadeFunction<F, NumericT, 4>)
+        if (preferred == 4) return fn(W4{ });
+
+    if constexpr (PacketShadeFunction<F, NumericT, 16>)
+        fn(W16{ });
+    else if constexpr (PacketShadeFunction<F, NumericT, 8>)
+        fn(W8{ });
+    else
+        fn(W4{ });
+}
+
+/// Shades @p count pixels of row @p y, starting at column @p x and
+/// advancing @p step columns per sample, into @p out.
+template<typename NumericT, typename ShadeFunction>
+inline void shadeRow(
+    const CameraView<NumericT>& cameraView,
+    std::size_t x,
+    std::size_t y,
+    std::size_t count,
+    std::size_t step,
+    ShadeFunction& sf,
+    std::size_t frame,
+    std::size_t timeMs,
+    std::size_t packetWidth,
+    utils::Vec<float, 3>* out)
+{
+    if constexpr (isPacketShadeFunction<ShadeFunction, NumericT>)
+    {
+        withPacketWidth<ShadeFunction, NumericT>(packetWidth, [&](auto width)
+        {
+            constexpr std::size_t N = decltype(width)::value;
+            RayPacket<NumericT, N> rays;
+            ColorPacket<N> colors;
+            for (std::size_t i = 0; i < count; i += N)
+            {
+                generateRayPacket(cameraView, x + i * step, y, count - i, step, rays);
+                sf(rays, frame, timeMs, colors);
+                for (std::size_t lane = 0; lane < rays.count; ++lane)
+                    out[i + lane] = utils::Vec<float, 3>{ colors.r[lane], colors.g[lane], colors.b[lane] };
+            }
+        });
+    }
+    else
+    {
+        // same incremental stepping as CameraView::Iterator, restarted per row
+        const NumericT uvStep =
+            NumericT(2) * static_cast<NumericT>(step) / static_cast<NumericT>(cameraView.width);
+        const auto rayStep = cameraView.stepX * static_cast<NumericT>(step);
+
+        PixelSample<NumericT> ps = cameraView.getPixelSample(x, y);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = sf(ps, frame, timeMs);
+            ps.pixelX += step;
+            ps.uv[0] += uvStep;
+            ps.ray.rot() += rayStep;
+        }
+    }
+}
+
+} // namespace internal
+
 template<typename NumericT, typename ShadeFunction>
 inline void render(
-    GLFWRenderer& renderer,
+    FrameBuffer& renderer,
     const internal::CameraView<NumericT>& cameraView,
     std::size_t frame,
     std::size_t timeMs,
     ShadeFunction sf
 )
 {
-    for (const auto& ps : cameraView)
+    SC_PROFILE_STAGE(Shade);
+    if constexpr (isPacketShadeFunction<ShadeFunction, NumericT>)
+    {
+        const std::size_t packetWidth = RenderParams{ }.packetWidth;
+        std::vector<utils::Vec<float, 3>> row(cameraView.width);
+        for (std::size_t y = 0; y < cameraView.height; ++y)
+        {
+            internal::shadeRow(cameraView, 0, y, cameraView.width, 1, sf, frame, timeMs,
+                               packetWidth, row.data());
+            renderer.writeSpan(0, y, row.data(), row.size());
+        }
+    }
+    else
     {
-        utils::Vec<float, 3> color = sf(ps, frame, timeMs);
-        renderer.setPixel(ps.pixelX, ps.pixelY, color);
+        for (const auto& ps : cameraView)
+        {
+            utils::Vec<float, 3> color = sf(ps, frame, timeMs);
+            renderer.setPixel(ps.pixelX, ps.pixelY, color);
+        }
     }
 }
 
-} // namespace sc
\ No newline at end of file
+/// Tile-parallel render(): the view is cut into params.tileSize squares
+/// that are shaded on @p pool in params.tileOrder.
+/// ShadeFunction is called concurrently and must not mutate shared state.
+/// Packet shade functions get params.packetWidth rays per call.
+template<typename NumericT, typename ShadeFunction>
+inline void render(
+    FrameBuffer& renderer,
+    const internal::CameraView<NumericT>& cameraView,
+    std::size_t frame,
+    std::size_t timeMs,
+    ShadeFunction sf,
+    utils::ThreadPool& pool,
+    const RenderParams& params
+)
+{
+    SC_PROFILE_STAGE(Shade);
+    const std::size_t tileSize = std::max<std::size_t>(params.tileSize, 1);
+    const std::size_t width = cameraView.width;
+    const std::size_t height = cameraView.height;
+    const std::size_t tilesX = (width + tileSize - 1) / tileSize;
+    const std::size_t tilesY = (height + tileSize - 1) / tileSize;
+
+    const auto tiles = utils::makeTileOrder(tilesX, tilesY, params.tileOrder);
+
+    // one cache-resident tile per slot, flushed to the framebuffer in one blit
+    std::vector<std::vector<utils::Vec<float, 3>>> scratch(
+        pool.size(), std::vector<utils::Vec<float, 3>>(tileSize * tileSize));
+
+    pool.parallelFor(tiles.size(), [&](std::size_t i, std::size_t slot)
+    {
+        const std::size_t tile = tiles[i];
+        const std::size_t x0 = (tile % tilesX) * tileSize;
+        const std::size_t y0 = (tile / tilesX) * tileSize;
+        const std::size_t x1 = std::min(x0 + tileSize, width);
+        const std::size_t y1 = std::min(y0 + tileSize, height);
+        utils::Vec<float, 3>* colors = scratch[slot].data();
+
+        for (std::size_t y = y0; y < y1; ++y)
+        {
+            internal::shadeRow(cameraView, x0, y, x1 - x0, 1, sf, frame, timeMs,
+                               params.packetWidth, colors + (y - y0) * tileSize);
+        }
+
+        renderer.blitTile(x0, y0, x1 - x0, y1 - y0, colors, tileSize);
+    });
+}
+
+} // namespace sc
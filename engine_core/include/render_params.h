@@ -0,0 +1,131 @@
+#pragma once
+
+#include "utils/frame_pacer.h"
+#include "utils/tiling.h"
+#include "utils/tone_mapping.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace sc
+{
+
+class FrameCapture;
+
+/// Texel layout GLFWRenderer streams to the GPU.
+/// BGRA8 matches the native layout of most drivers, so the driver can
+/// copy it without a conversion, at the cost of a 4-byte upload.
+enum class UploadFormat
+{
+    RGB8,
+    BGRA8,
+};
+
+struct UploadParams
+{
+    UploadFormat format = UploadFormat::RGB8;
+    /// Size of the pixel-buffer-object ring used by present().
+    /// 0 uploads straight from client memory.
+    std::size_t pixelBufferCount = 2;
+};
+
+/// Byte layout of the 8-bit FrameBuffer storage.
+/// The 4-byte layouts keep every pixel word aligned; their fourth byte is
+/// padding that present() ignores. BGRA8 is uploaded to GL without any
+/// conversion.
+enum class PixelFormat
+{
+    RGB8,
+    RGBX8,
+    BGRA8,
+};
+
+/// Storage options of FrameBuffer.
+struct FrameBufferParams
+{
+    PixelFormat pixelFormat = PixelFormat::RGB8;
+    /// Keep a linear float RGB buffer that setPixel writes unclamped;
+    /// resolve() turns it into the 8-bit buffer once per frame.
+    bool hdr = false;
+    ToneMapping toneMapping = ToneMapping::Clamp;
+    float exposure = 1.f;
+    /// Display gamma applied by resolve(); 1 keeps values linear.
+    float gamma = 1.f;
+    /// Store 8-bit rows top-down; the vertical flip then happens once,
+    /// when the GL quad is drawn, instead of on every write.
+    bool topDown = false;
+};
+
+/// Progressive refinement of the per-pixel entry points, see
+/// renderProgressive().
+struct ProgressiveParams
+{
+    bool enabled = false;
+    /// Pixel stride of the first pass after a view change: 4 shades 1/16
+    /// of the pixels, 2 shades 1/4. Rounded down to a power of two <= 16.
+    std::size_t startStride = 4;
+    /// Polled once per frame; returning true restarts refinement for state
+    /// the camera does not capture.
+    std::function<bool()> changed;
+};
+
+/// Frame-time driven render resolution of the windowed entry points, see
+/// DynamicResolution. The framebuffer and GL texture keep the camera
+/// resolution as capacity; frames render into their top-left part and
+/// are stretched to the window at present. Per-frame callbacks must draw
+/// at the framebuffer's current size; the mrc entry points do so with a
+/// scaled copy of the camera and pass custom drawers a zBuffer of which
+/// only that corner is valid. Offline drivers ignore it, as their output
+/// must not depend on timing.
+struct DynamicResolutionParams
+{
+    bool enabled = false;
+    /// Render-time budget per frame in ms; 0 uses the frame period of the
+    /// entry point.
+    double targetMs = 0.0;
+    /// Bounds of the per-axis scale relative to the camera resolution;
+    /// maxScale above 1 is clamped.
+    float minScale = .5f;
+    float maxScale = 1.f;
+    /// Frames between two resolution changes, which is also the smoothing
+    /// window of the measured render time.
+    std::size_t adjustInterval = 8;
+};
+
+/// Tuning knobs shared by the render entry points.
+struct RenderParams
+{
+    /// Threads used for shading, including the render thread itself.
+    /// 0 means std::thread::hardware_concurrency(), 1 renders serially.
+    /// Windows left at 0 share one pool, see utils::acquireThreadPool().
+    std::size_t threadCount = 0;
+    /// Edge length of the square screen tiles handed to workers, in pixels.
+    std::size_t tileSize = 32;
+    utils::TileOrder tileOrder = utils::TileOrder::RowMajor;
+    ProgressiveParams progressive;
+    /// Rays per call for packet shade functions: 4, 8 or 16. Falls back to
+    /// the widest width a shader accepts when it does not take this one.
+    std::size_t packetWidth = 8;
+    /// Clear the framebuffer before every per-frame callback. Turn it off
+    /// when the callback overwrites every pixel anyway.
+    bool clearEachFrame = true;
+    /// Render on a separate thread while the main thread polls events and
+    /// presents the previous frame. Input handlers, the render function and
+    /// the frame update then all run on the render thread.
+    bool threadedRender = false;
+    /// Framebuffers in flight with threadedRender: 2 keeps every frame,
+    /// 3 lets rendering run ahead and presents the newest finished frame.
+    std::size_t frameBufferCount = 2;
+    /// Receives the frame times of the render loop when set. It is written
+    /// by the thread running the frame update, read it from there or after
+    /// the loop returned.
+    utils::FrameStats* frameStats = nullptr;
+    /// Receives every presented frame when set, see FrameCapture. It must
+    /// outlive the render loop.
+    FrameCapture* capture = nullptr;
+    DynamicResolutionParams dynamicResolution;
+    UploadParams upload;
+    FrameBufferParams frameBuffer;
+};
+
+} // namespace sc
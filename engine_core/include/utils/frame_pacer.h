@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace sc::utils
+{
+
+/// Rolling frame-time statistics over the last capacity() frames.
+class FrameStats
+{
+public:
+    struct Summary
+    {
+        std::size_t frames = 0;
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+
+        [[nodiscard]] double fps() const { return meanMs > 0.0 ? 1000.0 / meanMs : 0.0; }
+    };
+
+    explicit FrameStats(std::size_t capacity = 240)
+        : _samples(std::max<std::size_t>(capacity, 1), 0.0)
+    {}
+
+    void record(double frameMs)
+    {
+        _samples[_next] = frameMs;
+        _next = (_next + 1) % _samples.size();
+        _count = std::min(_count + 1, _samples.size());
+        ++_totalFrames;
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return _samples.size(); }
+    [[nodiscard]] std::size_t size() const { return _count; }
+    /// Frames recorded since construction, not only the ones still kept.
+    [[nodiscard]] std::size_t totalFrames() const { return _totalFrames; }
+
+    /// Most recent frame time, 0 before the first record().
+    [[nodiscard]] double lastMs() const
+    {
+        return _count ? _samples[(_next + _samples.size() - 1) % _samples.size()] : 0.0;
+    }
+
+    /// Mean, nearest-rank percentiles and max of the kept frames.
+    [[nodiscard]] Summary summary() const
+    {
+        Summary s;
+        s.frames = _count;
+        if (_count == 0)
+            return s;
+
+        std::vector<double> sorted = ordered();
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (double ms : sorted)
+            sum += ms;
+
+        auto rank = [&](double p) {
+            const auto i = static_cast<std::size_t>(p * static_cast<double>(_count - 1) + .5);
+            return sorted[i];
+        };
+
+        s.meanMs = sum / static_cast<double>(_count);
+        s.p50Ms = rank(.50);
+        s.p95Ms = rank(.95);
+        s.p99Ms = rank(.99);
+        s.maxMs = sorted.back();
+        return s;
+    }
+
+    /// Kept frame times, oldest first, as "frame,ms" CSV rows.
+    void writeCsv(std::ostream& os) const
+    {
+        os << "frame,ms\n";
+        const std::size_t first = _totalFrames - _count;
+        const std::vector<double> samples = ordered();
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            os << first + i << ',' << samples[i] << '\n';
+    }
+
+private:
+    std::vector<double> _samples;
+    std::size_t _next = 0;
+    std::size_t _count = 0;
+    std::size_t _totalFrames = 0;
+
+    [[nodiscard]] std::vector<double> ordered() const
+    {
+        std::vector<double> out;
+        out.reserve(_count);
+        const std::size_t start = (_next + _samples.size() - _count) % _samples.size();
+        for (std::size_t i = 0; i < _count; ++i)
+            out.push_back(_samples[(start + i) % _samples.size()]);
+        return out;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const FrameStats::Summary& s)
+{
+    return os << "[FRAME ms] mean: " << s.meanMs
+              << " p50: " << s.p50Ms
+              << " p95: " << s.p95Ms
+              << " p99: " << s.p99Ms
+              << " max: " << s.maxMs
+              << " [FPS]: " << s.fps();
+}
+
+/// Sleeps until @p deadline, spinning the last @p spin of the wait, which
+/// OS sleep granularity cannot resolve.
+inline void sleepUntil(std::chrono::steady_clock::time_point deadline,
+                       std::chrono::steady_clock::duration spin)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (deadline - now > spin)
+        std::this_thread::sleep_for(deadline - now - spin);
+    while (std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+/// Keeps a loop on a fixed frame period measured with steady_clock.
+/// wait() sleeps through most of the remaining time and spins the last
+/// spinMs, which OS sleep granularity cannot resolve. Deadlines advance by
+/// whole periods so rounding never drifts; after a long stall the schedule
+/// restarts instead of bursting to catch up.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @param targetMs frame period, 0 runs unthrottled
+    /// @param stats    external sink for frame times, internal when null
+    explicit FramePacer(double targetMs, FrameStats* stats = nullptr, double spinMs = 1.5)
+        : _start(Clock::now())
+        , _frameStart(_start)
+        , _deadline(_start)
+        , _stats(stats ? stats : &_ownStats)
+    {
+        setTarget(targetMs);
+        setSpin(spinMs);
+    }
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    void setTarget(double targetMs)
+    {
+        _period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(std::max(targetMs, 0.0)));
+    }
+
+    void setSpin(double spinMs)
+    {
+        _spin = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(std::max(spinMs, 0.0)));
+    }
+
+    /// Waits for the end of the current frame period and records the frame.
+    /// @return time since the previous wait() (or construction), in ms
+    double wait()
+    {
+        _deadline += _period;
+
+        auto now = Clock::now();
+        if (now < _deadline)
+        {
+            sleepUntil(_deadline, _spin);
+            now = Clock::now();
+        }
+        else if (now - _deadline > _period)
+        {
+            _deadline = now;
+        }
+
+        const double frameMs =
+            std::chrono::duration<double, std::milli>(now - _frameStart).count();
+        _frameStart = now;
+        _stats->record(frameMs);
+        return frameMs;
+    }
+
+    /// Time since construction, in ms.
+    [[nodiscard]] double elapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    [[nodiscard]] const FrameStats& stats() const { return *_stats; }
+
+private:
+    Clock::time_point _start;
+    Clock::time_point _frameStart;
+    Clock::time_point _deadline;
+    Clock::duration _period{ };
+    Clock::duration _spin{ };
+    FrameStats _ownStats;
+    FrameStats* _stats;
+};
+
+} // namespace sc::utils
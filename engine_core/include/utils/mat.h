@@ -108,8 +108,15 @@ public:
     auto begin() const { return _data.begin(); }
     auto end() const { return _data.end(); }
 
+    NumericT* data() { return _data.data(); }
+    const NumericT* data() const { return _data.data(); }
+
 private:
-    Container _data{};
+    // rows of float 4x4 matrices load as aligned SSE registers
+    static constexpr std::size_t storageAlign =
+        (sizeof(NumericT) * Cols) % 16 == 0 ? 16 : alignof(Container);
+
+    alignas(storageAlign) Container _data{};
 };
 
 template<typename T, std::size_t R, std::size_t C>
@@ -192,4 +199,43 @@ Vec<T, C> operator*(const Vec<T, R>& v, const Mat<T, R, C>& m)
     return r;
 }
 
+#ifdef SC_VEC_SSE2
+
+/// Row-major 4x4 float kernels, preferred over the generic loops above.
+inline Vec<float, 4> operator*(const Mat<float, 4, 4>& m, const Vec<float, 4>& v)
+{
+    const __m128 x = _mm_load_ps(v.data());
+    __m128 r0 = _mm_mul_ps(_mm_load_ps(m.data()), x);
+    __m128 r1 = _mm_mul_ps(_mm_load_ps(m.data() + 4), x);
+    __m128 r2 = _mm_mul_ps(_mm_load_ps(m.data() + 8), x);
+    __m128 r3 = _mm_mul_ps(_mm_load_ps(m.data() + 12), x);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    Vec<float, 4> ret;
+    _mm_store_ps(ret.data(), _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3)));
+    return ret;
+}
+
+inline Mat<float, 4, 4> operator*(const Mat<float, 4, 4>& a, const Mat<float, 4, 4>& b)
+{
+    const __m128 b0 = _mm_load_ps(b.data());
+    const __m128 b1 = _mm_load_ps(b.data() + 4);
+    const __m128 b2 = _mm_load_ps(b.data() + 8);
+    const __m128 b3 = _mm_load_ps(b.data() + 12);
+
+    Mat<float, 4, 4> r;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        const float* row = a.data() + i * 4;
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+        _mm_store_ps(r.data() + i * 4, sum);
+    }
+    return r;
+}
+
+#endif
+
 } // namespace sc::utils
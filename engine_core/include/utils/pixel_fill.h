@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SC_PIXEL_FILL_SSE2
+#endif
+
+namespace sc::utils::internal
+{
+
+/// Fills @p pixels packed 3-byte pixels with (c0, c1, c2).
+/// Gray colors become a single memset; otherwise 16 pixels (three 16-byte
+/// stores) are written per iteration.
+inline void fillPixels3(unsigned char* dst,
+                        std::size_t pixels,
+                        unsigned char c0,
+                        unsigned char c1,
+                        unsigned char c2)
+{
+    if (c0 == c1 && c1 == c2)
+    {
+        std::memset(dst, c0, pixels * 3);
+        return;
+    }
+
+    std::size_t i = 0;
+
+#ifdef SC_PIXEL_FILL_SSE2
+    alignas(16) unsigned char pattern[48];
+    for (std::size_t p = 0; p < 16; ++p)
+    {
+        pattern[p * 3 + 0] = c0;
+        pattern[p * 3 + 1] = c1;
+        pattern[p * 3 + 2] = c2;
+    }
+    const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern));
+    const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+    const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 32));
+
+    for (; i + 16 <= pixels; i += 16)
+    {
+        auto* out = reinterpret_cast<__m128i*>(dst + i * 3);
+        _mm_storeu_si128(out + 0, a);
+        _mm_storeu_si128(out + 1, b);
+        _mm_storeu_si128(out + 2, c);
+    }
+#endif
+
+    for (; i < pixels; ++i)
+    {
+        dst[i * 3 + 0] = c0;
+        dst[i * 3 + 1] = c1;
+        dst[i * 3 + 2] = c2;
+    }
+}
+
+/// Fills @p pixels 4-byte pixels with the bytes of @p pixel.
+inline void fillPixels4(unsigned char* dst, std::size_t pixels, const unsigned char (&pixel)[4])
+{
+    if (pixel[0] == pixel[1] && pixel[1] == pixel[2] && pixel[2] == pixel[3])
+    {
+        std::memset(dst, pixel[0], pixels * 4);
+        return;
+    }
+
+    std::uint32_t value;
+    std::memcpy(&value, pixel, 4);
+    std::size_t i = 0;
+
+#ifdef SC_PIXEL_FILL_SSE2
+    const __m128i v = _mm_set1_epi32(static_cast<int>(value));
+    for (; i + 4 <= pixels; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+#endif
+
+    for (; i < pixels; ++i)
+        std::memcpy(dst + i * 4, &value, 4);
+}
+
+/// Fills @p pixels RGBX float pixels with (r, g, b, 0).
+inline void fillPixelsF4(float* dst, std::size_t pixels, float r, float g, float b)
+{
+    std::size_t i = 0;
+
+#ifdef SC_PIXEL_FILL_SSE2
+    const __m128 v = _mm_setr_ps(r, g, b, 0.f);
+    for (; i < pixels; ++i)
+        _mm_storeu_ps(dst + i * 4, v);
+#endif
+
+    for (; i < pixels; ++i)
+    {
+        dst[i * 4 + 0] = r;
+        dst[i * 4 + 1] = g;
+        dst[i * 4 + 2] = b;
+        dst[i * 4 + 3] = 0.f;
+    }
+}
+
+} // namespace sc::utils::internal
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace sc::utils
+{
+
+/// Frame stages that the engine and model_render_core time.
+enum class ProfileStage : std::uint32_t
+{
+    Update,           ///< each-frame update callbacks (efu / efmu)
+    Shade,            ///< per-pixel shading in sc::render
+    VertexTransform,  ///< model-to-world transform of vertices and normals
+    ClipProject,      ///< culling, attribute setup, near clipping, projection
+    Binning,          ///< triangle-to-tile binning
+    Rasterize,        ///< tile rasterization and fragment shading
+    CustomDrawer,     ///< user drawing on top of the model pass
+    Present,          ///< resolve, upload and buffer swap
+    Count
+};
+
+inline const char* stageName(ProfileStage stage)
+{
+    static constexpr std::array<const char*, static_cast<std::size_t>(ProfileStage::Count)> names = {
+        "update", "shade", "vertex_transform", "clip_project",
+        "binning", "rasterize", "custom_drawer", "present"
+    };
+    const auto i = static_cast<std::size_t>(stage);
+    return i < names.size() ? names[i] : "unknown";
+}
+
+/// One finished stage. Times are in microseconds since the profiler started.
+struct StageSample
+{
+    std::uint64_t frame = 0;
+    ProfileStage stage = ProfileStage::Update;
+    std::uint32_t thread = 0;
+    double startUs = 0.0;
+    double durationUs = 0.0;
+};
+
+/// Collects StageSamples into a fixed lock-free ring; the newest Capacity
+/// samples are kept. Any thread may record; snapshots skip slots that are
+/// being overwritten while they are read.
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t Capacity = std::size_t(1) << 14;
+
+    static Profiler& instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    /// Tags samples recorded from now on with @p frame.
+    void beginFrame(std::uint64_t frame)
+    {
+        _frame.store(frame, std::memory_order_relaxed);
+    }
+
+    void record(ProfileStage stage, Clock::time_point start, Clock::time_point end)
+    {
+        const std::uint64_t index = _next.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = _slots[index & (Capacity - 1)];
+
+        // odd sequence marks the slot as being written
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.frame.store(_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        slot.stage.store(static_cast<std::uint32_t>(stage), std::memory_order_relaxed);
+        slot.thread.store(threadIndex(), std::memory_order_relaxed);
+        slot.startNs.store(toNs(start - _origin), std::memory_order_relaxed);
+        slot.durationNs.store(toNs(end - start), std::memory_order_relaxed);
+
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    /// Completed samples currently in the ring, oldest first.
+    [[nodiscard]] std::vector<StageSample> snapshot() const
+    {
+        const std::uint64_t end = _next.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > Capacity ? end - Capacity : 0;
+
+        std::vector<StageSample> out;
+        out.reserve(static_cast<std::size_t>(end - begin));
+        for (std::uint64_t i = begin; i < end; ++i)
+        {
+            const Slot& slot = _slots[i & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != 2 * i + 2)
+                continue;
+
+            StageSample s;
+            s.frame = slot.frame.load(std::memory_order_relaxed);
+            s.stage = static_cast<ProfileStage>(slot.stage.load(std::memory_order_relaxed));
+            s.thread = slot.thread.load(std::memory_order_relaxed);
+            s.startUs = static_cast<double>(slot.startNs.load(std::memory_order_relaxed)) / 1000.0;
+            s.durationUs = static_cast<double>(slot.durationNs.load(std::memory_order_relaxed)) / 1000.0;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == 2 * i + 2)
+                out.push_back(s);
+        }
+        return out;
+    }
+
+    /// "frame,stage,thread,start_us,duration_us" rows.
+    void writeCsv(std::ostream& os) const
+    {
+        os << "frame,stage,thread,start_us,duration_us\n";
+        for (const auto& s : snapshot())
+        {
+            os << s.frame << ',' << stageName(s.stage) << ',' << s.thread << ','
+               << s.startUs << ',' << s.durationUs << '\n';
+        }
+    }
+
+    /// Chrome trace event JSON, loadable in chrome://tracing or Perfetto.
+    void writeJson(std::ostream& os) const
+    {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& s : snapshot())
+        {
+            os << (first ? "\n" : ",\n")
+               << "{\"name\":\"" << stageName(s.stage) << "\",\"ph\":\"X\""
+               << ",\"ts\":" << s.startUs << ",\"dur\":" << s.durationUs
+               << ",\"pid\":0,\"tid\":" << s.thread
+               << ",\"args\":{\"frame\":" << s.frame << "}}";
+            first = false;
+        }
+        os << "\n]}\n";
+    }
+
+    void clear()
+    {
+        for (auto& slot : _slots)
+            slot.sequence.store(0, std::memory_order_relaxed);
+        _next.store(0, std::memory_order_release);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{ 0 };
+        std::atomic<std::uint64_t> frame{ 0 };
+        std::atomic<std::uint32_t> stage{ 0 };
+        std::atomic<std::uint32_t> thread{ 0 };
+        std::atomic<std::int64_t> startNs{ 0 };
+        std::atomic<std::int64_t> durationNs{ 0 };
+    };
+
+    Profiler() : _origin(Clock::now()) {}
+
+    static std::int64_t toNs(Clock::duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+
+    /// Small stable per-thread id for trace viewers.
+    static std::uint32_t threadIndex()
+    {
+        static std::atomic<std::uint32_t> counter{ 0 };
+        thread_local const std::uint32_t index = counter.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    Clock::time_point _origin;
+    std::atomic<std::uint64_t> _frame{ 0 };
+    alignas(64) std::atomic<std::uint64_t> _next{ 0 };
+    std::array<Slot, Capacity> _slots;
+};
+
+/// Records the lifetime of the scope as one @p stage sample.
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(ProfileStage stage)
+        : _stage(stage)
+        , _start(Profiler::Clock::now())
+    {}
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    ~ScopedStageTimer()
+    {
+        Profiler::instance().record(_stage, _start, Profiler::Clock::now());
+    }
+
+private:
+    ProfileStage _stage;
+    Profiler::Clock::time_point _start;
+};
+
+} // namespace sc::utils
+
+#define SC_PROFILE_CONCAT_INNER(a, b) a##b
+#define SC_PROFILE_CONCAT(a, b) SC_PROFILE_CONCAT_INNER(a, b)
+
+/// Stage timing compiles away unless ENABLE_PROFILING is defined.
+#ifdef ENABLE_PROFILING
+#define SC_PROFILE_FRAME(frame) ::sc::utils::Profiler::instance().beginFrame(frame)
+#define SC_PROFILE_STAGE(stage) \
+    ::sc::utils::ScopedStageTimer SC_PROFILE_CONCAT(scStageTimer, __LINE__)(::sc::utils::ProfileStage::stage)
+#else
+#define SC_PROFILE_FRAME(frame) ((void)0)
+#define SC_PROFILE_STAGE(stage) ((void)0)
+#endif
@@ -8,7 +8,7 @@ namespace sc::utils
 template<
     typename NumericT,
     std::size_t N,
-    typename Container = std::array<NumericT, N>
+    typename Container = typename internal::VecStorage<NumericT, N>::type
 >
 class Ray
 {
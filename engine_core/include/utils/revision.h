@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace sc::utils
+{
+
+/// Change stamp for objects whose state is edited through mutable
+/// accessors. Every construction and touch() draws a process-wide unique
+/// value, copies keep it, so equal revisions mean equal contents. Owners
+/// touch() on each mutable access, which over-reports edits but catches
+/// every one made through a fresh accessor call. A reference kept from an
+/// earlier frame and written later is not seen: re-fetch it per frame or
+/// have the owner markDirty() after writing through it.
+class Revision
+{
+public:
+    Revision() : _value(next()) {}
+
+    void touch() { _value = next(); }
+
+    [[nodiscard]] std::uint64_t value() const { return _value; }
+
+    bool operator==(const Revision&) const = default;
+
+private:
+    std::uint64_t _value;
+
+    static std::uint64_t next()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
+
+} // namespace sc::utils
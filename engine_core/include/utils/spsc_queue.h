@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace sc::utils
+{
+
+/// Bounded lock-free queue for exactly one producer and one consumer
+/// thread. Capacity must be a power of two.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    /// Producer side. Returns false, dropping @p value, when the queue is full.
+    bool tryPush(const T& value)
+    {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        _items[head & (Capacity - 1)] = value;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side. Returns false when the queue is empty.
+    bool tryPop(T& value)
+    {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire))
+            return false;
+
+        value = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> _items{ };
+    alignas(64) std::atomic<std::size_t> _head{ 0 };
+    alignas(64) std::atomic<std::size_t> _tail{ 0 };
+};
+
+} // namespace sc::utils
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sc::utils
+{
+
+namespace internal
+{
+
+/// Contiguous slice of a parallelFor index space owned by one participant.
+/// The owner pops from the front, thieves split off the back half.
+struct alignas(64) WorkRange
+{
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+struct ParallelJob
+{
+    std::function<void(std::size_t, std::size_t)> body;
+    std::unique_ptr<WorkRange[]> ranges;
+    std::size_t slotCount = 0;
+    std::size_t nextSlot = 0;
+    std::atomic<std::size_t> remaining{0};
+    std::atomic<std::size_t> active{0};
+    /// Signalled by the last worker leaving the job.
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+};
+
+} // namespace internal
+
+/// Persistent worker pool with work-stealing parallelFor.
+/// The calling thread always participates, so a pool of N threads
+/// owns N - 1 workers. Nested parallelFor calls from inside a body
+/// are allowed: the nested caller drives its own job to completion.
+class ThreadPool
+{
+public:
+    /// @param threadCount total participants including the caller,
+    ///        0 picks std::thread::hardware_concurrency()
+    explicit ThreadPool(std::size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        _workers.reserve(threadCount - 1);
+        for (std::size_t i = 1; i < threadCount; ++i)
+            _workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (auto& worker : _workers)
+            worker.join();
+    }
+
+    [[nodiscard]] std::size_t size() const { return _workers.size() + 1; }
+
+    /// Calls fn(index, slot) for every index in [0, count) and blocks until
+    /// all calls returned. The index space is split into one contiguous
+    /// range per participant (so ordered inputs keep their locality) and
+    /// idle participants steal half of the largest remaining range.
+    /// @p slot is unique among concurrently running calls and lies in
+    /// [0, size()), so it can index per-thread scratch storage.
+    template<typename Fn>
+    void parallelFor(std::size_t count, Fn&& fn)
+    {
+        if (count == 0)
+            return;
+
+        if (_workers.empty() || count == 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                fn(i, std::size_t(0));
+            return;
+        }
+
+        internal::ParallelJob job;
+        job.body = [&fn](std::size_t i, std::size_t slot) { fn(i, slot); };
+        job.slotCount = std::min(size(), count);
+        job.ranges = std::make_unique<internal::WorkRange[]>(job.slotCount);
+        job.remaining.store(count, std::memory_order_relaxed);
+
+        const std::size_t chunk = count / job.slotCount;
+        const std::size_t extra = count % job.slotCount;
+        std::size_t begin = 0;
+        for (std::size_t s = 0; s < job.slotCount; ++s)
+        {
+            const std::size_t len = chunk + (s < extra ? 1 : 0);
+            job.ranges[s].begin = begin;
+            job.ranges[s].end = begin + len;
+            begin += len;
+        }
+
+        // slot 0 belongs to the caller
+        job.nextSlot = 1;
+        {
+            std::lock_guard lock(_mutex);
+            _jobs.push_back(&job);
+        }
+        _cv.notify_all();
+
+        runSlot(job, 0);
+
+        {
+            std::lock_guard lock(_mutex);
+            auto it = std::find(_jobs.begin(), _jobs.end(), &job);
+            if (it != _jobs.end())
+                _jobs.erase(it);
+        }
+
+        std::unique_lock lock(job.doneMutex);
+        job.doneCv.wait(lock, [&job] {
+            return job.remaining.load(std::memory_order_acquire) == 0 &&
+                   job.active.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+private:
+    void workerLoop()
+    {
+        for (;;)
+        {
+            internal::ParallelJob* job = nullptr;
+            std::size_t slot = 0;
+            {
+                std::unique_lock lock(_mutex);
+                _cv.wait(lock, [this] { return _stop || !_jobs.empty(); });
+                if (_jobs.empty())
+                    return;
+
+                job = _jobs.front();
+                slot = job->nextSlot++;
+                if (job->nextSlot == job->slotCount)
+                    _jobs.pop_front();
+                job->active.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            runSlot(*job, slot);
+
+            // notify while holding the lock: the job lives on the caller's
+            // stack and is gone as soon as the caller sees active == 0
+            std::lock_guard lock(job->doneMutex);
+            if (job->active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                job->doneCv.notify_one();
+        }
+    }
+
+    static void runSlot(internal::ParallelJob& job, std::size_t slot)
+    {
+        std::size_t index = 0;
+        for (;;)
+        {
+            if (!popFront(job.ranges[slot], index))
+            {
+                if (!steal(job, slot))
+                    return;
+                continue;
+            }
+
+            job.body(index, slot);
+            job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    static bool popFront(internal::WorkRange& range, std::size_t& index)
+    {
+        std::lock_guard lock(range.mutex);
+        if (range.begin == range.end)
+            return false;
+        index = range.begin++;
+        return true;
+    }
+
+    /// Moves the back half of the fullest foreign range into @p slot's range.
+    static bool steal(internal::ParallelJob& job, std::size_t slot)
+    {
+        for (;;)
+        {
+            std::size_t victim = job.slotCount;
+            std::size_t best = 0;
+            for (std::size_t s = 0; s < job.slotCount; ++s)
+            {
+                if (s == slot)
+                    continue;
+                std::lock_guard lock(job.ranges[s].mutex);
+                const std::size_t left = job.ranges[s].end - job.ranges[s].begin;
+                if (left > best)
+                {
+                    best = left;
+                    victim = s;
+                }
+            }
+
+            if (victim == job.slotCount)
+                return false;
+
+            std::size_t stolenBegin = 0;
+            std::size_t stolenEnd = 0;
+            {
+                auto& range = job.ranges[victim];
+                std::lock_guard lock(range.mutex);
+                const std::size_t left = range.end - range.begin;
+                if (left == 0)
+                    continue;
+                stolenEnd = range.end;
+                stolenBegin = range.end - (left + 1) / 2;
+                range.end = stolenBegin;
+            }
+
+            auto& own = job.ranges[slot];
+            std::lock_guard lock(own.mutex);
+            own.begin = stolenBegin;
+            own.end = stolenEnd;
+            return true;
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::deque<internal::ParallelJob*> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+};
+
+/// Pool for a renderer asking for @p threadCount threads. An explicit count
+/// gets a pool of its own; 0 shares one hardware_concurrency() pool with
+/// every other such renderer alive, so windows rendering concurrently do
+/// not each spawn a worker per core.
+inline std::shared_ptr<ThreadPool> acquireThreadPool(std::size_t threadCount)
+{
+    if (threadCount != 0)
+        return std::make_shared<ThreadPool>(threadCount);
+
+    static std::mutex mutex;
+    static std::weak_ptr<ThreadPool> shared;
+
+    std::lock_guard lock(mutex);
+    auto pool = shared.lock();
+    if (!pool)
+    {
+        pool = std::make_shared<ThreadPool>();
+        shared = pool;
+    }
+    return pool;
+}
+
+} // namespace sc::utils
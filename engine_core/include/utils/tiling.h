@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace sc::utils
+{
+
+/// Order in which screen tiles are handed out to worker threads.
+enum class TileOrder
+{
+    RowMajor,   ///< left to right, top to bottom
+    Morton,     ///< Z-order curve, keeps consecutive tiles spatially close
+    CenterOut,  ///< nearest to the screen center first
+};
+
+namespace internal
+{
+
+inline std::uint32_t spreadBits(std::uint32_t v)
+{
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+} // namespace internal
+
+/// Returns row-major tile indices (ty * tilesX + tx) permuted into @p order.
+inline std::vector<std::size_t> makeTileOrder(std::size_t tilesX,
+                                              std::size_t tilesY,
+                                              TileOrder order)
+{
+    std::vector<std::size_t> tiles(tilesX * tilesY);
+    std::iota(tiles.begin(), tiles.end(), std::size_t(0));
+
+    if (order == TileOrder::Morton)
+    {
+        auto key = [tilesX](std::size_t t) {
+            const auto tx = static_cast<std::uint32_t>(t % tilesX);
+            const auto ty = static_cast<std::uint32_t>(t / tilesX);
+            return internal::spreadBits(tx) | (internal::spreadBits(ty) << 1);
+        };
+        std::stable_sort(tiles.begin(), tiles.end(),
+            [&key](std::size_t a, std::size_t b) { return key(a) < key(b); });
+    }
+    else if (order == TileOrder::CenterOut)
+    {
+        // doubled coordinates keep the center exact for even tile counts
+        const auto cx = static_cast<long long>(tilesX) - 1;
+        const auto cy = static_cast<long long>(tilesY) - 1;
+        auto key = [tilesX, cx, cy](std::size_t t) {
+            const long long dx = 2 * static_cast<long long>(t % tilesX) - cx;
+            const long long dy = 2 * static_cast<long long>(t / tilesX) - cy;
+            return dx * dx + dy * dy;
+        };
+        std::stable_sort(tiles.begin(), tiles.end(),
+            [&key](std::size_t a, std::size_t b) { return key(a) < key(b); });
+    }
+
+    return tiles;
+}
+
+} // namespace sc::utils
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SC_TONE_MAPPING_SSE2
+#endif
+
+namespace sc
+{
+
+/// Curve applied to linear HDR values before quantization.
+enum class ToneMapping
+{
+    Clamp,      ///< values above 1 saturate, identical to the RGB8 path
+    Reinhard,   ///< c / (1 + c)
+    Aces,       ///< Narkowicz' fit of the ACES filmic curve
+};
+
+} // namespace sc
+
+namespace sc::utils::internal
+{
+
+/// Gamma is applied by quantizing to LUT_BITS first and looking the
+/// 8-bit result up, which keeps pow() out of the per-pixel loop.
+constexpr std::size_t LUT_BITS = 12;
+constexpr std::size_t LUT_SIZE = std::size_t(1) << LUT_BITS;
+
+using GammaLut = std::array<unsigned char, LUT_SIZE>;
+
+inline void buildGammaLut(GammaLut& lut, float gamma)
+{
+    const float invGamma = 1.f / gamma;
+    for (std::size_t i = 0; i < LUT_SIZE; ++i)
+    {
+        const float v = static_cast<float>(i) / static_cast<float>(LUT_SIZE - 1);
+        lut[i] = static_cast<unsigned char>(std::pow(v, invGamma) * 255.f + .5f);
+    }
+}
+
+inline float toneMapScalar(float c, ToneMapping op)
+{
+    switch (op)
+    {
+    case ToneMapping::Reinhard:
+        return c / (1.f + c);
+    case ToneMapping::Aces:
+        return (c * (2.51f * c + .03f)) / (c * (2.43f * c + .59f) + .14f);
+    default:
+        return c;
+    }
+}
+
+#ifdef SC_TONE_MAPPING_SSE2
+inline __m128 toneMapSse(__m128 c, ToneMapping op)
+{
+    switch (op)
+    {
+    case ToneMapping::Reinhard:
+        return _mm_div_ps(c, _mm_add_ps(_mm_set1_ps(1.f), c));
+    case ToneMapping::Aces:
+    {
+        const __m128 num = _mm_mul_ps(c,
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.51f), c), _mm_set1_ps(.03f)));
+        const __m128 den = _mm_add_ps(_mm_mul_ps(c,
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.43f), c), _mm_set1_ps(.59f))),
+            _mm_set1_ps(.14f));
+        return _mm_div_ps(num, den);
+    }
+    default:
+        return c;
+    }
+}
+#endif
+
+/// Exposure, tone mapping, gamma and 8-bit quantization of one row.
+/// @p src holds @p width RGBX float pixels, @p dst receives 8-bit pixels
+/// of @p dstStride bytes (3 or 4, the fourth byte set to 255), red first
+/// unless @p bgra. Without @p lut channels are truncated like
+/// FrameBuffer::setPixel does.
+inline void quantizeRow(const float* src,
+                        unsigned char* dst,
+                        std::size_t width,
+                        float exposure,
+                        ToneMapping op,
+                        const GammaLut* lut,
+                        std::size_t dstStride = 3,
+                        bool bgra = false)
+{
+    const int redOffset = bgra ? 2 : 0;
+    const float scale = lut ? static_cast<float>(LUT_SIZE - 1) : 255.f;
+    std::size_t x = 0;
+
+#ifdef SC_TONE_MAPPING_SSE2
+    const __m128 vExposure = _mm_set1_ps(exposure);
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+
+    auto quantize = [&](const float* p) {
+        __m128 c = _mm_mul_ps(_mm_loadu_ps(p), vExposure);
+        c = _mm_min_ps(_mm_max_ps(toneMapSse(c, op), zero), one);
+        return _mm_cvttps_epi32(_mm_mul_ps(c, vScale));
+    };
+
+    alignas(16) std::int16_t q[16];
+    for (; x + 4 <= width; x += 4)
+    {
+        const float* p = src + x * 4;
+        const __m128i lo = _mm_packs_epi32(quantize(p), quantize(p + 4));
+        const __m128i hi = _mm_packs_epi32(quantize(p + 8), quantize(p + 12));
+        _mm_store_si128(reinterpret_cast<__m128i*>(q), lo);
+        _mm_store_si128(reinterpret_cast<__m128i*>(q + 8), hi);
+
+        unsigned char* out = dst + x * dstStride;
+        for (std::size_t i = 0; i < 4; ++i, out += dstStride)
+        {
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                const auto v = static_cast<std::size_t>(q[i * 4 + ch]);
+                out[std::abs(redOffset - ch)] =
+                    lut ? (*lut)[v] : static_cast<unsigned char>(v);
+            }
+            if (dstStride == 4)
+                out[3] = 255;
+        }
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+        unsigned char* out = dst + x * dstStride;
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            float c = toneMapScalar(src[x * 4 + ch] * exposure, op);
+            // Written so NaN lands on 0 like the _mm_max_ps path above.
+            c = c > 0.f ? std::min(c, 1.f) : 0.f;
+            const auto v = static_cast<std::size_t>(c * scale);
+            out[std::abs(redOffset - ch)] =
+                lut ? (*lut)[v] : static_cast<unsigned char>(v);
+        }
+        if (dstStride == 4)
+            out[3] = 255;
+    }
+}
+
+} // namespace sc::utils::internal
@@ -3,15 +3,96 @@
 #include <cstddef>
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <complex>
+#include <functional>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SC_VEC_SSE2
+#endif
 
 namespace sc::utils
 {
 
+namespace internal
+{
+
+/// Four float lanes, 16-byte aligned, exposing only the first N. The unused
+/// lanes stay zero so whole-register kernels can run on N = 3.
+template<typename NumericT, std::size_t N>
+struct PaddedArray
+{
+    static_assert(N <= 4);
+
+    alignas(16) NumericT lanes[4]{ };
+
+    constexpr NumericT& operator[](std::size_t ind) { return lanes[ind]; }
+    constexpr const NumericT& operator[](std::size_t ind) const { return lanes[ind]; }
+
+    constexpr NumericT* begin() { return lanes; }
+    constexpr NumericT* end() { return lanes + N; }
+    constexpr const NumericT* begin() const { return lanes; }
+    constexpr const NumericT* end() const { return lanes + N; }
+
+    constexpr NumericT* data() { return lanes; }
+    constexpr const NumericT* data() const { return lanes; }
+
+    static constexpr std::size_t size() { return N; }
+};
+
+template<typename NumericT, std::size_t N>
+struct VecStorage
+{
+    using type = std::array<NumericT, N>;
+};
+
+#ifdef SC_VEC_SSE2
+template<>
+struct VecStorage<float, 3>
+{
+    using type = PaddedArray<float, 3>;
+};
+
+template<>
+struct VecStorage<float, 4>
+{
+    using type = PaddedArray<float, 4>;
+};
+#endif
+
+/// Marks the lazy expression nodes built by lazy().
+template<typename T>
+struct IsVecExpr : std::false_type {};
+
+template<typename T>
+concept VecExpression = IsVecExpr<std::remove_cvref_t<T>>::value;
+
+#ifdef SC_VEC_SSE2
+/// Expressions over padded float vectors evaluate in one SSE register.
+template<typename Expr, typename Container>
+concept PacketExpression = requires(const Expr& e) {
+    e.packet();
+} && std::is_same_v<Container, PaddedArray<float, std::remove_cvref_t<Expr>::size>>;
+
+template<std::size_t N>
+inline void storePacket(float* dst, __m128 r)
+{
+    if constexpr (N == 3)
+        r = _mm_and_ps(r, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+    _mm_store_ps(dst, r);
+}
+#endif
+
+} // namespace internal
+
+/// Vec<float, 3> and Vec<float, 4> default to padded SSE storage where it
+/// is available; the operators below then take the SIMD kernels.
 template<
     typename NumericT,
     std::size_t N,
-    typename Container = std::array<NumericT, N>
+    typename Container = typename internal::VecStorage<NumericT, N>::type
 >
 class Vec
 {
@@ -19,11 +100,11 @@ public:
 
     Vec() = default;
 
-    explicit Vec(const Container& data)
+    constexpr explicit Vec(const Container& data)
         : _data(data)
     {}
 
-    explicit Vec(Container&& data)
+    constexpr explicit Vec(Container&& data)
         : _data(std::move(data))
     {}
 
@@ -34,7 +115,7 @@ public:
             (std::is_arithmetic_v<std::decay_t<Args>> && ...)
         >
     >
-    explicit Vec(Args&&... args)
+    constexpr explicit Vec(Args&&... args)
         : _data{ static_cast<NumericT>(std::forward<Args>(args))... }
     {}
 
@@ -56,17 +137,36 @@ public:
             });
     }
 
-    NumericT& operator[](std::size_t ind) { return _data[ind]; }
+    /// Evaluates a lazy expression (see lazy()) in a single loop.
+    template<internal::VecExpression Expr>
+        requires (std::remove_cvref_t<Expr>::size == N)
+    constexpr Vec(const Expr& expr)
+    {
+#ifdef SC_VEC_SSE2
+        if constexpr (internal::PacketExpression<Expr, Container>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                internal::storePacket<N>(_data.data(), expr.packet());
+                return;
+            }
+        }
+#endif
+        for (std::size_t i = 0; i < N; ++i)
+            _data[i] = static_cast<NumericT>(expr[i]);
+    }
+
+    constexpr NumericT& operator[](std::size_t ind) { return _data[ind]; }
 
-    const NumericT& operator[](std::size_t ind) const { return _data[ind]; }
+    constexpr const NumericT& operator[](std::size_t ind) const { return _data[ind]; }
 
-    auto begin() { return _data.begin(); }
-    auto end() { return _data.end(); }
-    auto begin() const { return _data.begin(); }
-    auto end() const { return _data.end(); }
+    constexpr auto begin() { return _data.begin(); }
+    constexpr auto end() { return _data.end(); }
+    constexpr auto begin() const { return _data.begin(); }
+    constexpr auto end() const { return _data.end(); }
 
-    NumericT* data() { return _data.data(); }
-    const NumericT* data() const { return _data.data(); }
+    constexpr NumericT* data() { return _data.data(); }
+    constexpr const NumericT* data() const { return _data.data(); }
 
 private:
     Container _data;
@@ -339,4 +439,338 @@ T getCos(const Vec<T, 3, C>& a,
     return dot(a, b) / (len(a) * len(b));
 }
 
+namespace internal
+{
+
+template<typename T>
+struct IsVec : std::false_type {};
+
+#ifdef SC_VEC_SSE2
+inline __m128 packetOp(std::plus<>, __m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 packetOp(std::minus<>, __m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 packetOp(std::multiplies<>, __m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+inline __m128 packetOp(std::divides<>, __m128 a, __m128 b) { return _mm_div_ps(a, b); }
+#endif
+
+template<typename NumericT, std::size_t N, typename Container>
+struct IsVec<Vec<NumericT, N, Container>> : std::true_type {};
+
+template<typename T>
+concept ExprOperand = VecExpression<T>
+    || IsVec<std::remove_cvref_t<T>>::value
+    || std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+/// Leaf referring to a Vec; the Vec must outlive the evaluation.
+template<typename NumericT, std::size_t N, typename Container>
+class VecLeaf
+{
+public:
+    using value_type = NumericT;
+    static constexpr std::size_t size = N;
+
+    constexpr explicit VecLeaf(const Vec<NumericT, N, Container>& vec) : _vec(vec) {}
+
+    constexpr NumericT operator[](std::size_t ind) const { return _vec[ind]; }
+
+#ifdef SC_VEC_SSE2
+    __m128 packet() const requires std::is_same_v<Container, PaddedArray<float, N>>
+    {
+        return _mm_load_ps(_vec.data());
+    }
+#endif
+
+private:
+    const Vec<NumericT, N, Container>& _vec;
+};
+
+/// Scalar broadcast to every component.
+template<typename NumericT>
+class ScalarLeaf
+{
+public:
+    using value_type = NumericT;
+
+    constexpr explicit ScalarLeaf(NumericT value) : _value(value) {}
+
+    constexpr NumericT operator[](std::size_t) const { return _value; }
+
+#ifdef SC_VEC_SSE2
+    __m128 packet() const requires std::is_same_v<NumericT, float>
+    {
+        return _mm_set1_ps(_value);
+    }
+#endif
+
+private:
+    NumericT _value;
+};
+
+template<typename Op, typename L, typename R>
+class BinaryExpr
+{
+public:
+    using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+    static constexpr std::size_t size = [] {
+        if constexpr (requires { L::size; })
+            return L::size;
+        else
+            return R::size;
+    }();
+
+    constexpr BinaryExpr(const L& l, const R& r) : _l(l), _r(r) {}
+
+    constexpr value_type operator[](std::size_t ind) const { return Op{}(_l[ind], _r[ind]); }
+
+#ifdef SC_VEC_SSE2
+    __m128 packet() const requires requires(const L& l, const R& r) { l.packet(); r.packet(); }
+    {
+        return packetOp(Op{}, _l.packet(), _r.packet());
+    }
+#endif
+
+private:
+    L _l;
+    R _r;
+};
+
+template<typename E>
+class NegateExpr
+{
+public:
+    using value_type = typename E::value_type;
+    static constexpr std::size_t size = E::size;
+
+    constexpr explicit NegateExpr(const E& e) : _e(e) {}
+
+    constexpr value_type operator[](std::size_t ind) const { return -_e[ind]; }
+
+#ifdef SC_VEC_SSE2
+    __m128 packet() const requires requires(const E& e) { e.packet(); }
+    {
+        return _mm_sub_ps(_mm_setzero_ps(), _e.packet());
+    }
+#endif
+
+private:
+    E _e;
+};
+
+template<typename Op, typename L, typename R>
+struct IsVecExpr<BinaryExpr<Op, L, R>> : std::true_type {};
+
+template<typename E>
+struct IsVecExpr<NegateExpr<E>> : std::true_type {};
+
+template<typename NumericT, std::size_t N, typename Container>
+struct IsVecExpr<VecLeaf<NumericT, N, Container>> : std::true_type {};
+
+template<ExprOperand T>
+constexpr auto toOperand(const T& operand)
+{
+    if constexpr (VecExpression<T>)
+        return operand;
+    else if constexpr (std::is_arithmetic_v<T>)
+        return ScalarLeaf<T>(operand);
+    else
+        return VecLeaf(operand);
+}
+
+template<typename L, typename R>
+concept ExprOperands = ExprOperand<L> && ExprOperand<R>
+    && (VecExpression<L> || VecExpression<R>);
+
+template<typename Op, typename L, typename R>
+constexpr auto makeBinary(const L& l, const R& r)
+{
+    using LOp = decltype(toOperand(l));
+    using ROp = decltype(toOperand(r));
+    if constexpr (requires { LOp::size; ROp::size; })
+        static_assert(LOp::size == ROp::size, "vector sizes differ");
+    return BinaryExpr<Op, LOp, ROp>(toOperand(l), toOperand(r));
+}
+
+template<typename L, typename R> requires ExprOperands<L, R>
+constexpr auto operator+(const L& l, const R& r) { return makeBinary<std::plus<>>(l, r); }
+
+template<typename L, typename R> requires ExprOperands<L, R>
+constexpr auto operator-(const L& l, const R& r) { return makeBinary<std::minus<>>(l, r); }
+
+template<typename L, typename R> requires ExprOperands<L, R>
+constexpr auto operator*(const L& l, const R& r) { return makeBinary<std::multiplies<>>(l, r); }
+
+template<typename L, typename R> requires ExprOperands<L, R>
+constexpr auto operator/(const L& l, const R& r) { return makeBinary<std::divides<>>(l, r); }
+
+template<VecExpression E>
+constexpr auto operator-(const E& e) { return NegateExpr<E>(e); }
+
+} // namespace internal
+
+/// Opt-in lazy arithmetic. Operators on lazy(v) build an expression that
+/// is evaluated component-wise in one loop when it is converted to a Vec,
+/// with no temporary Vec per operator. Plain Vecs and scalars may be mixed
+/// in. Operands are referenced, so evaluate within the same full
+/// expression; do not keep the expression in an auto variable.
+template<typename NumericT, std::size_t N, typename Container>
+constexpr auto lazy(const Vec<NumericT, N, Container>& vec)
+{
+    return internal::VecLeaf<NumericT, N, Container>(vec);
+}
+
+/// Evaluates @p expr into a Vec of its value type.
+template<internal::VecExpression Expr>
+constexpr auto eval(const Expr& expr)
+{
+    using E = std::remove_cvref_t<Expr>;
+    return Vec<typename E::value_type, E::size>(expr);
+}
+
+#ifdef SC_VEC_SSE2
+
+/// Padded float vectors. These overloads are more specialized than the
+/// generic ones above, so existing code picks them up unchanged.
+template<std::size_t N>
+using SimdVec = Vec<float, N, internal::PaddedArray<float, N>>;
+
+namespace internal
+{
+
+template<std::size_t N>
+inline __m128 load(const SimdVec<N>& v)
+{
+    return _mm_load_ps(v.data());
+}
+
+/// Stores @p r, clearing the pad lane of 3-vectors.
+template<std::size_t N>
+inline SimdVec<N> store(__m128 r)
+{
+    if constexpr (N == 3)
+    {
+        const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        r = _mm_and_ps(r, mask);
+    }
+    SimdVec<N> ret;
+    _mm_store_ps(ret.data(), r);
+    return ret;
+}
+
+/// Sum of all four lanes, broadcast.
+inline __m128 horizontalSum(__m128 v)
+{
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_ps(sums, shuf);
+}
+
+} // namespace internal
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline void operator+=(SimdVec<N>& a, const SimdVec<N>& b)
+{
+    _mm_store_ps(a.data(), _mm_add_ps(internal::load(a), internal::load(b)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator+(const SimdVec<N>& a, const SimdVec<N>& b)
+{
+    return internal::store<N>(_mm_add_ps(internal::load(a), internal::load(b)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator+(const SimdVec<N>& a, float scalar)
+{
+    return internal::store<N>(_mm_add_ps(internal::load(a), _mm_set1_ps(scalar)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator-(const SimdVec<N>& a)
+{
+    return internal::store<N>(_mm_sub_ps(_mm_setzero_ps(), internal::load(a)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator-(const SimdVec<N>& a, const SimdVec<N>& b)
+{
+    return internal::store<N>(_mm_sub_ps(internal::load(a), internal::load(b)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator-(const SimdVec<N>& a, float scalar)
+{
+    return internal::store<N>(_mm_sub_ps(internal::load(a), _mm_set1_ps(scalar)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator*(const SimdVec<N>& a, const SimdVec<N>& b)
+{
+    return internal::store<N>(_mm_mul_ps(internal::load(a), internal::load(b)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator*(const SimdVec<N>& a, float scalar)
+{
+    return internal::store<N>(_mm_mul_ps(internal::load(a), _mm_set1_ps(scalar)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator*(float scalar, const SimdVec<N>& a)
+{
+    return a * scalar;
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator/(const SimdVec<N>& a, const SimdVec<N>& b)
+{
+    return internal::store<N>(_mm_div_ps(internal::load(a), internal::load(b)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> operator/(const SimdVec<N>& a, float scalar)
+{
+    return internal::store<N>(_mm_div_ps(internal::load(a), _mm_set1_ps(scalar)));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> clamp(const SimdVec<N>& a, float min, float max)
+{
+    const __m128 r = _mm_min_ps(_mm_set1_ps(max), internal::load(a));
+    return internal::store<N>(_mm_max_ps(_mm_set1_ps(min), r));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline float dot(const SimdVec<N>& a, const SimdVec<N>& b)
+{
+    const __m128 p = _mm_mul_ps(internal::load(a), internal::load(b));
+    return _mm_cvtss_f32(internal::horizontalSum(p));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline float len(const SimdVec<N>& vec)
+{
+    const __m128 v = internal::load(vec);
+    return _mm_cvtss_f32(_mm_sqrt_ss(internal::horizontalSum(_mm_mul_ps(v, v))));
+}
+
+template<std::size_t N> requires (N == 3 || N == 4)
+inline SimdVec<N> norm(const SimdVec<N>& vec)
+{
+    const __m128 v = internal::load(vec);
+    const __m128 length = _mm_sqrt_ps(internal::horizontalSum(_mm_mul_ps(v, v)));
+    return internal::store<N>(_mm_div_ps(v, length));
+}
+
+inline SimdVec<3> cross(const SimdVec<3>& a, const SimdVec<3>& b)
+{
+    const __m128 va = internal::load(a);
+    const __m128 vb = internal::load(b);
+    const __m128 aYzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 bYzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 r = _mm_sub_ps(_mm_mul_ps(va, bYzx), _mm_mul_ps(aYzx, vb));
+    return internal::store<3>(_mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 0, 2, 1)));
+}
+
+#endif
+
 } // namespace sc::utils
\ No newline at end of file
@@ -2,10 +2,21 @@
 
 #include "camera/camera.h"
 #include "render.h"
+#include "progressive_render.h"
 #include "glfw_render.h"
 #include "camera/camera_view_iterator.h"
-
+#include "dynamic_resolution.h"
+#include "frame_capture.h"
+#include "render_params.h"
+#include "utils/frame_pacer.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <thread>
 #include <utility>
 
@@ -19,6 +30,23 @@ namespace sc
 template<typename T, std::size_t N>
 using VecArray = utils::Vec<T, N>;
 
+namespace windowInternal
+{
+
+#ifdef ENABLE_LOG
+/// Prints the rolling frame-time summary once per 60 frames.
+inline void logFrameStats(std::size_t frame, std::size_t timeMs, const utils::FrameStats& stats)
+{
+    if (frame % 60 != 0)
+        return;
+    std::cout << "[FRAME]: " << frame << " ";
+    std::cout << "[TIME ms]: " << timeMs << " ";
+    std::cout << stats.summary() << "\n";
+}
+#endif
+
+} // namespace windowInternal
+
 template<typename RenderFunc, typename FrameUpdate>
 class Window
 {
@@ -26,12 +54,19 @@ public:
     Window(GLFWRenderer&& renderer,
            RenderFunc rf,
            FrameUpdate efu,
-           float targetMsPerFrame)
+           float targetMsPerFrame,
+           const DynamicResolutionParams& dynamicResolution = { })
         : _renderer(std::move(renderer))
         , _rf(std::move(rf))
         , _efu(std::move(efu))
         , _targetMsPerFrame(targetMsPerFrame)
-    {}
+    {
+        if (dynamicResolution.enabled)
+        {
+            _resolution.emplace(_renderer.capacityWidth(), _renderer.capacityHeight(),
+                                dynamicResolution, targetMsPerFrame);
+        }
+    }
 
     Window(const Window&) = delete;
     Window& operator=(const Window&) = delete;
@@ -43,26 +78,75 @@ public:
     {
         if (shouldClose()) return;
 
-        auto start = std::chrono::system_clock::now();
-        _rf(_renderer, _frame, _time);
+        beginFrame(utils::FramePacer::Clock::now());
+        renderFrame();
+        present();
+        endFrame();
+    }
+
+    /// Main thread: starts a frame at @p now and schedules the next one
+    /// a frame budget later.
+    void beginFrame(utils::FramePacer::Clock::time_point now)
+    {
+        if (_frame == 0)
+            _firstTick = now;
+        else
+            _stats.record(std::chrono::duration<double, std::milli>(now - _lastTick).count());
+        _lastTick = now;
+        _time = static_cast<std::size_t>(
+            std::chrono::duration<double, std::milli>(now - _firstTick).count());
+
+        const auto budget = std::chrono::duration_cast<utils::FramePacer::Clock::duration>(
+            std::chrono::duration<float, std::milli>(_targetMsPerFrame));
+        _nextDue = (now - _nextDue > budget ? now : _nextDue) + budget;
+
+        SC_PROFILE_FRAME(_frame);
+    }
+
+    /// Runs the render function into this window's framebuffer. Touches no
+    /// GL state, so several windows may render on worker threads at once.
+    void renderFrame()
+    {
+        internal::renderScaled(_resolution ? &*_resolution : nullptr, _renderer, _rf, _frame, _time);
+    }
+
+    /// Main thread: uploads the frame and swaps.
+    void present()
+    {
+        SC_PROFILE_STAGE(Present);
         _renderer.present();
-        _efu(_frame, _time);
+    }
+
+    /// Main thread: runs the frame update and advances the frame counter.
+    void endFrame()
+    {
+        {
+            SC_PROFILE_STAGE(Update);
+            _efu(_frame, _time);
+        }
         ++_frame;
-        auto end = std::chrono::system_clock::now();
-        auto elapsedTime = std::chrono::duration_cast<
-            std::chrono::milliseconds>(end - start).count();
-        _time += elapsedTime;
 
 #ifdef ENABLE_LOG
-        std::cout << "[FRAME]: " << _frame << " ";
-        std::cout << "[TIME ms]:  " << _time << " ";
-        std::cout << "[RENDER TIME ms]: " << elapsedTime << " ";
-        std::cout << "[FPS]: " << 1000. / static_cast<float>(elapsedTime) << "\n";
+        windowInternal::logFrameStats(_frame, _time, _stats);
 #endif
     }
 
     [[nodiscard]] bool shouldClose() const { return _renderer.shouldClose(); }
 
+    [[nodiscard]] float targetMsPerFrame() const { return _targetMsPerFrame; }
+
+    /// Start of the next frame budget; the window is due once it passed.
+    [[nodiscard]] utils::FramePacer::Clock::time_point nextDue() const { return _nextDue; }
+
+    /// Intervals between consecutive tick() calls.
+    [[nodiscard]] const utils::FrameStats& frameStats() const { return _stats; }
+
+    /// Resolution controller, null unless dynamic resolution is enabled.
+    [[nodiscard]] const DynamicResolution* dynamicResolution() const
+    {
+        return _resolution ? &*_resolution : nullptr;
+    }
+
     GLFWRenderer& renderer() { return _renderer; }
     const GLFWRenderer& renderer() const { return _renderer; }
 
@@ -71,8 +155,13 @@ private:
     RenderFunc _rf;
     FrameUpdate _efu;
     float _targetMsPerFrame;
+    std::optional<DynamicResolution> _resolution;
     std::size_t _frame = 0;
     std::size_t _time = 0;
+    utils::FramePacer::Clock::time_point _firstTick;
+    utils::FramePacer::Clock::time_point _lastTick;
+    utils::FramePacer::Clock::time_point _nextDue;
+    utils::FrameStats _stats;
 };
 
 namespace windowInternal
@@ -84,7 +173,10 @@ GLFWRenderer makeRenderer(
     utils::Vec<int, 2> windowResolution,
     const char* title,
     const std::vector<std::pair<std::vector<int>, std::function<void()>>>& keyHandlers,
-    const std::function<void(double, double)>& mouseHandler)
+    const std::function<void(double, double)>& mouseHandler,
+    const UploadParams& upload = { },
+    const FrameBufferParams& frameBuffer = { },
+    FrameCapture* capture = nullptr)
 {
     utils::Vec<int, 2> windowRes(windowResolution);
     if (windowRes[0] <= 0 || windowRes[1] <= 0)
@@ -97,7 +189,9 @@ GLFWRenderer makeRenderer(
         static_cast<int>(camera.res()[0]),
         static_cast<int>(camera.res()[1]),
         windowRes,
-        title
+        title,
+        upload,
+        frameBuffer
     );
 
     for (const auto& [key, handler] : keyHandlers)
@@ -106,9 +200,20 @@ GLFWRenderer makeRenderer(
     if (mouseHandler)
         renderer.onMouseMove(mouseHandler);
 
+    if (capture)
+        renderer.onPresent([capture](const FrameBuffer& frame) { capture->capture(frame); });
+
     return renderer;
 }
 
+/// Calls @p fn on the @p index-th window of the pack.
+template<typename Fn, typename... Windows>
+void forWindowAt(std::size_t index, Fn&& fn, Windows&... windows)
+{
+    std::size_t i = 0;
+    ((i++ == index ? fn(windows) : void()), ...);
+}
+
 } // namespace windowInternal
 
 template<typename NumericT,
@@ -122,21 +227,25 @@ auto makePerFrameWindow(
     const std::function<void(double, double)>& mouseHandler = { },
     utils::Vec<int, 2> windowResolution = utils::Vec<int, 2>{-1, -1},
     unsigned int targetFrameRateMs = 60,
-    const char* title = "Renderer")
+    const char* title = "Renderer",
+    const RenderParams& params = { })
 {
     const float targetMsPerFrame = 1000.f / static_cast<float>(targetFrameRateMs);
 
     auto renderer = windowInternal::makeRenderer(
-        camera, windowResolution, title, keyHandlers, mouseHandler);
+        camera, windowResolution, title, keyHandlers, mouseHandler,
+        params.upload, params.frameBuffer, params.capture);
 
-    auto wrapped = [ff = std::move(ff)](
+    auto wrapped = [ff = std::move(ff), clearEachFrame = params.clearEachFrame](
         GLFWRenderer& r, std::size_t frame, std::size_t time) mutable
     {
-        r.clear();
+        if (clearEachFrame)
+            r.clear();
         ff(r, frame, time);
     };
 
-    return Window(std::move(renderer), std::move(wrapped), std::move(efu), targetMsPerFrame);
+    return Window(std::move(renderer), std::move(wrapped), std::move(efu), targetMsPerFrame,
+                  params.dynamicResolution);
 }
 
 template<typename NumericT,
@@ -150,20 +259,30 @@ auto makeEachPixelWindow(
     const std::function<void(double, double)>& mouseHandler = { },
     utils::Vec<int, 2> windowResolution = utils::Vec<int, 2>{-1, -1},
     unsigned int targetFrameRateMs = 60,
-    const char* title = "Renderer")
+    const char* title = "Renderer",
+    const RenderParams& params = { })
 {
     const float targetMsPerFrame = 1000.f / static_cast<float>(targetFrameRateMs);
 
     auto renderer = windowInternal::makeRenderer(
-        camera, windowResolution, title, keyHandlers, mouseHandler);
+        camera, windowResolution, title, keyHandlers, mouseHandler,
+        params.upload, params.frameBuffer, params.capture);
 
-    auto wrapped = [&camera, sf = std::move(sf)](
+    auto pool = utils::acquireThreadPool(params.threadCount);
+
+    auto wrapped = [&camera, sf = std::move(sf), pool, params,
+                    progressive = ProgressiveState<NumericT>(params.progressive)](
         GLFWRenderer& r, std::size_t frame, std::size_t time) mutable
     {
-        render(r, makeViewFromCamera(camera), frame, time, sf);
+        const auto view = makeViewFromCamera(camera, r.getRenderWidth(), r.getRenderHeight());
+        if (params.progressive.enabled)
+            renderProgressive(r, view, frame, time, sf, *pool, params, progressive);
+        else
+            render(r, view, frame, time, sf, *pool, params);
     };
 
-    return Window(std::move(renderer), std::move(wrapped), std::move(efu), targetMsPerFrame);
+    return Window(std::move(renderer), std::move(wrapped), std::move(efu), targetMsPerFrame,
+                  params.dynamicResolution);
 }
 
 template<typename... Windows>
@@ -178,34 +297,56 @@ void runWindows(Windows&... windows)
         }(), ...);
     }
 
-    constexpr float targetMsPerFrame = 1000.f / 60.f;
+    using Clock = utils::FramePacer::Clock;
+    constexpr std::size_t windowCount = sizeof...(Windows);
+    constexpr auto spin = std::chrono::microseconds(1500);
+
+    // Windows whose budget elapsed render concurrently; GL work (present)
+    // and the frame updates stay serial on this thread, so updates may
+    // share state across windows without locking. Windows created with the
+    // default threadCount shade on one shared pool, so this only adds a
+    // driving thread per window, not a worker set per window.
+    utils::ThreadPool pool(windowCount);
+    std::array<bool, windowCount> due{ };
 
     bool anyOpen = true;
     while (anyOpen)
     {
-        auto loopStart = std::chrono::system_clock::now();
-
         glfwPollEvents();
         anyOpen = false;
 
+        const auto now = Clock::now();
+        auto wake = now + std::chrono::seconds(1);
+        std::size_t i = 0;
         ([&] {
-            if (!windows.shouldClose())
+            const bool open = !windows.shouldClose();
+            // a single window keeps being paced by vsync
+            due[i] = open && (windowCount == 1 || windows.nextDue() <= now);
+            if (due[i])
+                windows.beginFrame(now);
+            if (open)
+                wake = std::min(wake, windows.nextDue());
+            anyOpen |= open;
+            ++i;
+        }(), ...);
+
+        pool.parallelFor(windowCount, [&](std::size_t w, std::size_t) {
+            if (due[w])
+                windowInternal::forWindowAt(w, [](auto& win) { win.renderFrame(); }, windows...);
+        });
+
+        i = 0;
+        ([&] {
+            if (due[i])
             {
-                windows.tick();
-                anyOpen = true;
+                windows.present();
+                windows.endFrame();
             }
+            ++i;
         }(), ...);
 
-        // For multi-window: single sleep to target ~60 fps
-        if constexpr (sizeof...(Windows) > 1)
-        {
-            auto loopEnd = std::chrono::system_clock::now();
-            auto elapsed = std::chrono::duration_cast<
-                std::chrono::milliseconds>(loopEnd - loopStart).count();
-            int diff = static_cast<int>(targetMsPerFrame) - static_cast<int>(elapsed);
-            if (diff > 0)
-                std::this_thread::sleep_for(std::chrono::milliseconds(diff));
-        }
+        if (windowCount > 1 && anyOpen)
+            utils::sleepUntil(wake, spin);
     }
 }
 
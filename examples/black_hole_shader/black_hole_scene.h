@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ray_marching_iterator.h"
+#include "curvature/spherical_curvature.h"
+#include "object/sphere.h"
+#include "camera/camera_view.h"
+
+#include <memory>
+
+namespace black_hole
+{
+
+/// Two spheres around a black hole; shared by the example and render_bench.
+template<typename fpT>
+rmc::Scene<fpT> makeScene()
+{
+    auto sphereShape =
+    std::make_shared<rmc::object::Sphere<fpT>>(
+        sc::utils::Vec<fpT,3>{0.f,0.f,0.f}, 0.5f
+    );
+
+    auto sphere1Shape =
+    std::make_shared<rmc::object::Sphere<fpT>>(
+        sc::utils::Vec<fpT,3>{0.f,0.f,0.f}, 1.f, sc::utils::Vec<fpT,3>{1.f,.2f,1.f}
+    );
+
+    rmc::object::SceneObject<fpT> sphere(
+        sphereShape,
+        sc::utils::Vec<float, 3>{0.f, 0.f, 0.f}
+    );
+
+    rmc::object::SceneObject<fpT> sphere1(
+        sphere1Shape
+    );
+
+    auto bhCurvature = std::make_shared<rmc::curvature::BlackHole<fpT>>();
+    bhCurvature->center = sc::utils::Vec<fpT, 3>{0.f, 0.f, 0.f};
+    bhCurvature->schwarzschildRadius = .7f;
+    bhCurvature->influenceRadius = .7f;
+    bhCurvature->strength = .5f;
+
+    rmc::Scene<fpT> scene;
+    scene.addObject(sphere);
+    scene.addObject(sphere1);
+    scene.addCurvature(bhCurvature);
+    return scene;
+}
+
+template<typename fpT>
+sc::utils::Vec<float, 3> shaderFunction(const sc::PixelSample<fpT>& ps, const rmc::Scene<fpT>& scene)
+{
+    rmc::RayMarchingResult<fpT> rayMarchingResult = rmc::marchRay(ps.ray, scene);
+    if (rayMarchingResult.reachedThreshold)
+    {
+        return rayMarchingResult.material.color;
+    }
+    return sc::utils::Vec<float, 3>{.3f, .05f, .2f};
+}
+
+} // namespace black_hole
@@ -103,7 +103,7 @@ int main()
         std::size_t,
         sc::GLFWRenderer& renderer,
         const sc::utils::Mat<float, 4, 4>& proj,
-        const std::vector<std::vector<float>>& zBuffer)
+        const mrc::DepthBuffer<float>& zBuffer)
     {
         for (std::size_t i = 0; i < sourceModels.size(); ++i)
         {
@@ -114,12 +114,12 @@ int main()
                 auto tempV = sc::utils::rotateEuler(v, model.rot()) + model.pos();
                 auto projV = mrc::projectVertex(tempV, proj, camera1);
                 float currentZ = 1.f / projV.invW;
-                if (projV.pixel[0] < 0 || projV.pixel[0] >= zBuffer[0].size()
-                    || projV.pixel[1] < 0 || projV.pixel[1] >= zBuffer.size())
+                if (projV.pixel[0] < 0 || projV.pixel[0] >= zBuffer.width()
+                    || projV.pixel[1] < 0 || projV.pixel[1] >= zBuffer.height())
                     continue;
                 if (currentZ > 0 && currentZ - .05f <
-                    zBuffer[static_cast<std::size_t>(projV.pixel[1])]
-                           [static_cast<std::size_t>(projV.pixel[0])])
+                    zBuffer.at(static_cast<std::size_t>(projV.pixel[0]),
+                               static_cast<std::size_t>(projV.pixel[1])))
                     projectedPoints.emplace_back(projV.pixel);
             }
             auto hull = calculateConvexHull(projectedPoints);
@@ -175,7 +175,7 @@ int main()
         coneUpdate,
         [](std::size_t, std::size_t, sc::GLFWRenderer&,
            const sc::utils::Mat<float, 4, 4>&,
-           const std::vector<std::vector<float>>&){},
+           const mrc::DepthBuffer<float>&){},
         {}, {}, 60, "Cone Models");
 
     auto intersectionUpdate = [&](std::size_t, std::size_t) {
@@ -195,7 +195,7 @@ int main()
         std::size_t,
         sc::GLFWRenderer& renderer,
         const sc::utils::Mat<float, 4, 4>& viewProj,
-        const std::vector<std::vector<float>>&)
+        const mrc::DepthBuffer<float>&)
     {
         std::vector<sc::utils::Vec<float, 3>> objectCenters;
 
@@ -2,10 +2,7 @@
 #include "model/io.h"
 #include "snapshot.h"
 #include "sfm/run_sfm.h"
-#ifndef STB_IMAGE_WRITE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#endif
-#include "model/thirdparty/stb_image_write.h" // hehe
+#include "frame_capture.h"
 
 inline float dotThree(const sc::utils::Vec<float, 2>& a, const sc::utils::Vec<float, 2>& b,
                       const sc::utils::Vec<float, 2>& c) {
@@ -68,14 +65,14 @@ int main() {
     }};
 
     std::vector<sc::utils::Vec<float, 2>> lastRoi;
-    const unsigned char* lastBuffer = nullptr;
+    const sc::FrameBuffer* lastFrame = nullptr;
 
-    auto roiDrawer = [&models, &cam, &lastRoi, &lastBuffer](
+    auto roiDrawer = [&models, &cam, &lastRoi, &lastFrame](
         std::size_t,
         std::size_t,
         sc::GLFWRenderer& renderer,
         const sc::utils::Mat<float, 4, 4>& proj,
-        const std::vector<std::vector<float>>& zBuffer)
+        const mrc::DepthBuffer<float>& zBuffer)
     {
         for (std::size_t i = 0; i < models.size(); ++i)
         {
@@ -86,12 +83,12 @@ int main() {
                 auto tempV = sc::utils::rotateEuler(v, model.rot()) + model.pos();
                 auto projV = mrc::projectVertex(tempV, proj, cam);
                 float currentZ = 1.f / projV.invW;
-                if (projV.pixel[0] < 0 || projV.pixel[0] >= zBuffer[0].size()
-                    || projV.pixel[1] < 0 || projV.pixel[1] >= zBuffer.size())
+                if (projV.pixel[0] < 0 || projV.pixel[0] >= zBuffer.width()
+                    || projV.pixel[1] < 0 || projV.pixel[1] >= zBuffer.height())
                     continue;
                 if (currentZ > 0 && currentZ - .05f <
-                    zBuffer[static_cast<std::size_t>(projV.pixel[1])]
-                           [static_cast<std::size_t>(projV.pixel[0])])
+                    zBuffer.at(static_cast<std::size_t>(projV.pixel[0]),
+                               static_cast<std::size_t>(projV.pixel[1])))
                     projectedPoints.emplace_back(projV.pixel);
             }
             auto hull = calculateConvexHull(projectedPoints);
@@ -104,7 +101,7 @@ int main() {
                                    [&projectedPoints](std::size_t idx) {
                                        return projectedPoints[idx];
                                    });
-            lastBuffer = renderer.getBufferPtr();
+            lastFrame = &renderer;
 
             for (std::size_t j = 1; j < hull.size(); ++j) {
                 mrc::gt::drawLine(
@@ -117,41 +114,34 @@ int main() {
         }
     };
 
-    std::size_t imCount = 0;
     std::string baseDBPath = std::string(PROJECT_DIR) + "/db";
 
     std::string imagesPath = baseDBPath + "/images";
 
 
 
-    std::vector<std::pair<std::vector<int>, std::function<void()>>> customKeys = {
-        {{GLFW_KEY_LEFT_ALT, GLFW_KEY_E}, [&lastRoi, &lastBuffer, &cam, &imCount, &imagesPath]() {
-
-            // mirorring buffer horizontally
-            const std::size_t stride = static_cast<std::size_t>(cam.res()[0]) * 3;
-            std::vector resultingImage(lastBuffer, lastBuffer
-                + static_cast<std::size_t>(cam.res()[1]) * stride);
-            auto row_begin = [&resultingImage, &stride](std::size_t row) {
-                return resultingImage.begin() + row * stride;
-            };
-            const auto height = static_cast<std::size_t>(cam.res()[1]);
-            for (std::size_t row = 0; row < height / 2; ++row) {
-                auto top_row = row_begin(row);
-                auto bottom_row = row_begin(height - 1 - row);
-                std::swap_ranges(top_row, top_row + stride, bottom_row);
-            }
+    // images are encoded in the background; Block keeps every requested one
+    sc::FrameCapture capture(sc::CaptureParams{
+        .format = sc::CaptureFormat::Png,
+        .path = imagesPath + "/image",
+        .queueDepth = 2,
+        .encoderThreads = 1,
+        .overflow = sc::CaptureOverflow::Block,
+    });
 
-            std::string filename = imagesPath + "/image" + std::to_string(imCount++) + ".png";
-            int success = stbi_write_png(filename.c_str(), cam.res()[0], cam.res()[1],
-                3, resultingImage.data(), stride);
-            if (!success) {
-                std::cerr << "Error writing png image to file: " << filename << std::endl;
-            }
+    std::vector<std::pair<std::vector<int>, std::function<void()>>> customKeys = {
+        {{GLFW_KEY_LEFT_ALT, GLFW_KEY_E}, [&lastFrame, &capture]() {
+            if (lastFrame)
+                capture.capture(*lastFrame);
         }}
     };
 
     mrc::initMrcRender(cam, models, lights, {}, roiDrawer, customKeys);
 
+    capture.close();
+    if (const auto stats = capture.stats(); stats.failed > 0)
+        std::cerr << "Error writing " << stats.failed << " png images to " << imagesPath << std::endl;
+
     std::string dbPath = baseDBPath + "/database.db";
 
     const auto pnts = runSfM(dbPath, imagesPath);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace mrc
+{
+
+namespace gt
+{
+
+/// Default tile size (pixels).  32x32 tile z-buffer (4 KB for float)
+/// must fit comfortably in L1 cache.
+constexpr int TILE_SIZE = 32;
+
+} // namespace gt
+
+/// Per-pixel depth of a frame, stored tile by tile: every gt::TILE_SIZE
+/// square is one contiguous, cache-line aligned block in a single
+/// allocation, so a rasterizer working on a tile touches only its block.
+///
+/// clear() only marks the tiles stale; a stale tile is reset to
+/// max() when the rasterizer first asks for it and reads as max() until
+/// then, so a frame pays for the tiles it draws into, not for the screen.
+template<typename NumericT>
+class DepthBuffer
+{
+public:
+    static constexpr std::size_t tileSize = static_cast<std::size_t>(gt::TILE_SIZE);
+
+    DepthBuffer(std::size_t width, std::size_t height)
+        : _width(width)
+        , _height(height)
+        , _tilesX((width + tileSize - 1) / tileSize)
+        , _tilesY((height + tileSize - 1) / tileSize)
+        , _tiles(std::make_unique<Tile[]>(_tilesX * _tilesY))
+        , _stale(_tilesX * _tilesY, 1)
+    { }
+
+    [[nodiscard]] std::size_t width() const { return _width; }
+    [[nodiscard]] std::size_t height() const { return _height; }
+    [[nodiscard]] std::size_t tilesX() const { return _tilesX; }
+    [[nodiscard]] std::size_t tilesY() const { return _tilesY; }
+
+    /// Resets every pixel to max(), lazily.
+    void clear() { std::fill(_stale.begin(), _stale.end(), std::uint8_t(1)); }
+
+    /// True while tile (tx, ty) reads as max() everywhere and was not
+    /// handed out by tile() since the last clear().
+    [[nodiscard]] bool stale(std::size_t tx, std::size_t ty) const { return _stale[ty * _tilesX + tx] != 0; }
+
+    /// Depth at (x, y); max() where nothing was drawn since clear().
+    [[nodiscard]] NumericT at(std::size_t x, std::size_t y) const
+    {
+        const std::size_t tile = (y / tileSize) * _tilesX + x / tileSize;
+        if (_stale[tile])
+            return std::numeric_limits<NumericT>::max();
+        return _tiles[tile].depth[(y % tileSize) * tileSize + x % tileSize];
+    }
+
+    /// Writable depth at (x, y), resetting its tile first if it is stale.
+    NumericT& at(std::size_t x, std::size_t y)
+    {
+        return tile(x / tileSize, y / tileSize)[(y % tileSize) * tileSize + x % tileSize];
+    }
+
+    /// Depth block of tile (tx, ty), tileSize x tileSize and row-major,
+    /// reset first if it is stale. Distinct tiles may be used from
+    /// different threads at the same time.
+    NumericT* tile(std::size_t tx, std::size_t ty)
+    {
+        const std::size_t index = ty * _tilesX + tx;
+        auto& depth = _tiles[index].depth;
+        if (_stale[index])
+        {
+            depth.fill(std::numeric_limits<NumericT>::max());
+            _stale[index] = 0;
+        }
+        return depth.data();
+    }
+
+private:
+    struct alignas(64) Tile
+    {
+        std::array<NumericT, tileSize * tileSize> depth;
+    };
+
+    std::size_t _width;
+    std::size_t _height;
+    std::size_t _tilesX;
+    std::size_t _tilesY;
+    std::unique_ptr<Tile[]> _tiles;
+    /// One byte per tile, not vector<bool>, so threads on different tiles
+    /// never write the same word.
+    std::vector<std::uint8_t> _stale;
+};
+
+} // namespace mrc
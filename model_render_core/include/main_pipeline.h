@@ -1,21 +1,64 @@
 #pragma once
 
 #include "entry_point.h"
+#include "offline_render.h"
 #include "model/model.h"
+#include "scene_tracker.h"
 #include "utils/point_projection.h"
 #include "utils/graphics_tools.h"
 #include "utils/tiled_rasterizer.h"
 #include "utils/compute_normals.h"
 #include "utils/vertices_transform.h"
+#include "utils/parallel_chunks.h"
+#include "utils/profiler.h"
 
 #include <memory>
 #include <algorithm>
+#include <cstdint>
+#include <type_traits>
 
 namespace mrc {
 
 namespace internal
 {
 
+/// Runs the custom drawer; a drawer returning true asks to rasterize the
+/// next frame even if the scene looks unchanged. Drawers returning void
+/// never do.
+template<typename CustomDrawer, typename... Args>
+bool runCustomDrawer(CustomDrawer& cd, Args&&... args)
+{
+    SC_PROFILE_STAGE(CustomDrawer);
+    if constexpr (std::is_convertible_v<std::invoke_result_t<CustomDrawer&, Args...>, bool>)
+        return static_cast<bool>(cd(std::forward<Args>(args)...));
+    else
+    {
+        cd(std::forward<Args>(args)...);
+        return false;
+    }
+}
+
+/// The camera to rasterize @p frame with: @p camera itself, or @p scaled
+/// set to the frame's size when dynamic resolution shrank it.
+template<typename NumericT>
+const sc::Camera<NumericT, sc::VecArray>& frameCamera(
+    const sc::Camera<NumericT, sc::VecArray>& camera,
+    const sc::FrameBuffer& frame,
+    sc::Camera<NumericT, sc::VecArray>& scaled)
+{
+    const std::size_t width = frame.getRenderWidth();
+    const std::size_t height = frame.getRenderHeight();
+    if (static_cast<std::size_t>(camera.res()[0]) == width
+        && static_cast<std::size_t>(camera.res()[1]) == height)
+    {
+        return camera;
+    }
+
+    scaled = camera;
+    scaled.setRes(sc::utils::Vec<NumericT, 2>{static_cast<NumericT>(width), static_cast<NumericT>(height)});
+    return scaled;
+}
+
 template<typename NumericT>
 struct DefaultShaderFactory
 {
@@ -165,102 +208,188 @@ struct DefaultShaderFactory
     }
 };
 
+/// Shader type MakeShader builds for a model.
 template<typename NumericT, typename MakeShader>
+using ShaderOf = std::decay_t<std::invoke_result_t<MakeShader&, const Model<NumericT>&>>;
+
+/// Working buffers of renderSingleFrame(), owned by the entry point so
+/// their capacity carries over from frame to frame.
+template<typename NumericT, typename Shader>
+struct FrameScratch
+{
+    std::vector<Shader> shaders;
+    /// World-space verticies and normals of the model being projected.
+    std::vector<sc::utils::Vec<NumericT, 3>> transformedVerts;
+    std::vector<sc::utils::Vec<NumericT, 3>> transformedNormals;
+    /// Triangles of all models; modelIds[i] picks the shader of triangle i.
+    std::vector<std::array<ProjectedVertex<NumericT>, 3>> projected;
+    std::vector<std::uint32_t> modelIds;
+    std::vector<std::vector<std::array<ProjectedVertex<NumericT>, 3>>> chunkTriangles;
+    std::vector<std::size_t> chunkStart;
+    gt::TileBins<NumericT> bins;
+};
+
+/// Projects every model, then bins and rasterizes the triangles of the
+/// whole frame in one pass, each shaded by makeShader(its model).
+template<typename NumericT, typename MakeShader, typename Shader>
 void renderSingleFrame(const std::vector<Model<NumericT>>& models,
                        const sc::utils::Mat<NumericT, 4, 4>& projView,
                        MakeShader&& makeShader,
-                       SceneCache<NumericT>& sceneCache)
+                       SceneCache<NumericT>& sceneCache,
+                       FrameScratch<NumericT, Shader>& scratch)
 {
     using Vec3 = sc::utils::Vec<NumericT, 3>;
     using Vec2 = sc::utils::Vec<NumericT, 2>;
 
     const auto& cameraPos = sceneCache.camera.pos();
-
-    // Reused across models so the allocation persists.
-    std::vector<std::array<ProjectedVertex<NumericT>, 3>> projected;
+    auto* pool = sceneCache.pool;
+
+    // Triangles of all models, binned and rasterized once per frame.
+    auto& projected = scratch.projected;
+    auto& modelIds = scratch.modelIds;
+    auto& chunkTriangles = scratch.chunkTriangles;
+    auto& chunkStart = scratch.chunkStart;
+    auto& shaders = scratch.shaders;
+    auto& transformedVerts = scratch.transformedVerts;
+    auto& transformedNormals = scratch.transformedNormals;
+    shaders.clear();
+    shaders.reserve(models.size());
+
+    // one reserve for the frame: reserving per model would reallocate the
+    // whole list for every model
+    std::size_t faceTotal = 0;
+    for (const auto& model : models)
+        faceTotal += model.faces().size();
+    projected.clear();
+    modelIds.clear();
+    projected.reserve(faceTotal);
+    modelIds.reserve(faceTotal);
 
     for (const auto& model : models)
     {
-        auto shader = makeShader(model);
-
-        auto transformedVerts = internal::transformVerticies(
-            model.verticies(), model.pos(), model.rot());
-        auto transformedNormals = internal::transformNormals(
-            model.normals(), model.rot());
+        const auto modelId = static_cast<std::uint32_t>(shaders.size());
+        shaders.push_back(makeShader(model));
 
-        projected.clear();
-        projected.reserve(model.faces().size());
+        {
+            SC_PROFILE_STAGE(VertexTransform);
+            internal::transformVerticies(
+                model.verticies(), model.pos(), model.rot(), transformedVerts, pool);
+            internal::transformNormals(
+                model.normals(), model.rot(), transformedNormals, pool);
+        }
 
-        for (std::size_t f = 0; f < model.faces().size(); ++f)
+        // Appends the clipped, projected triangles of faces [begin, end).
+        const auto projectFaces = [&](std::size_t begin, std::size_t end,
+                                      std::vector<std::array<ProjectedVertex<NumericT>, 3>>& out)
         {
-            const auto& face = model.faces()[f];
+            for (std::size_t f = begin; f < end; ++f)
+            {
+                const auto& face = model.faces()[f];
 
-            auto faceNormal = getFaceNormal(transformedVerts, face);
+                auto faceNormal = getFaceNormal(transformedVerts, face);
 
-            auto p0 = transformedVerts[face[0][0]];
+                auto p0 = transformedVerts[face[0][0]];
 
-            Vec3 toCamera = cameraPos - p0;
-            if (sc::utils::dot(faceNormal, toCamera) <= NumericT(0))
-                continue;
+                Vec3 toCamera = cameraPos - p0;
+                if (sc::utils::dot(faceNormal, toCamera) <= NumericT(0))
+                    continue;
 
-            auto p1 = transformedVerts[face[1][0]];
-            auto p2 = transformedVerts[face[2][0]];
+                auto p1 = transformedVerts[face[1][0]];
+                auto p2 = transformedVerts[face[2][0]];
 
-            Vec2 uv0{}, uv1{}, uv2{};
-            if (face[0][1] < model.uv().size()) uv0 = model.uv()[face[0][1]];
-            if (face[1][1] < model.uv().size()) uv1 = model.uv()[face[1][1]];
-            if (face[2][1] < model.uv().size()) uv2 = model.uv()[face[2][1]];
+                Vec2 uv0{}, uv1{}, uv2{};
+                if (face[0][1] < model.uv().size()) uv0 = model.uv()[face[0][1]];
+                if (face[1][1] < model.uv().size()) uv1 = model.uv()[face[1][1]];
+                if (face[2][1] < model.uv().size()) uv2 = model.uv()[face[2][1]];
 
-            auto edge1 = p1 - p0;
-            auto edge2 = p2 - p0;
-            auto duv1 = uv1 - uv0;
-            auto duv2 = uv2 - uv0;
+                auto edge1 = p1 - p0;
+                auto edge2 = p2 - p0;
+                auto duv1 = uv1 - uv0;
+                auto duv2 = uv2 - uv0;
 
-            NumericT det = duv1[0] * duv2[1] - duv2[0] * duv1[1];
+                NumericT det = duv1[0] * duv2[1] - duv2[0] * duv1[1];
 
-            Vec3 faceTangent{1, 0, 0};
-            Vec3 faceBitangent{0, 1, 0};
+                Vec3 faceTangent{1, 0, 0};
+                Vec3 faceBitangent{0, 1, 0};
 
-            if (std::abs(det) > NumericT(1e-8))
-            {
-                NumericT invDet = NumericT(1) / det;
-                faceTangent   = sc::utils::norm(
-                    (edge1 * duv2[1] - edge2 * duv1[1]) * invDet);
-                faceBitangent = sc::utils::norm(
-                    (edge2 * duv1[0] - edge1 * duv2[0]) * invDet);
-            }
+                if (std::abs(det) > NumericT(1e-8))
+                {
+                    NumericT invDet = NumericT(1) / det;
+                    faceTangent   = sc::utils::norm(
+                        (edge1 * duv2[1] - edge2 * duv1[1]) * invDet);
+                    faceBitangent = sc::utils::norm(
+                        (edge2 * duv1[0] - edge1 * duv2[0]) * invDet);
+                }
 
-            // Build clip-space vertices with attributes
-            std::array<ClipVertex<NumericT>, 3> clipVerts;
-            for (int i = 0; i < 3; ++i)
-            {
-                auto wsPos = transformedVerts[face[i][0]];
+                // Build clip-space vertices with attributes
+                std::array<ClipVertex<NumericT>, 3> clipVerts;
+                for (int i = 0; i < 3; ++i)
+                {
+                    auto wsPos = transformedVerts[face[i][0]];
+
+                    VertexAttributes<NumericT> attr;
+                    attr.worldPos  = wsPos;
+                    attr.tangent   = faceTangent;
+                    attr.bitangent = faceBitangent;
 
-                VertexAttributes<NumericT> attr;
-                attr.worldPos  = wsPos;
-                attr.tangent   = faceTangent;
-                attr.bitangent = faceBitangent;
+                    if (face[i][1] < model.uv().size())
+                        attr.uv = model.uv()[face[i][1]];
 
-                if (face[i][1] < model.uv().size())
-                    attr.uv = model.uv()[face[i][1]];
+                    if (face[i][2] < transformedNormals.size())
+                        attr.normal = transformedNormals[face[i][2]];
+                    else
+                        attr.normal = faceNormal;
 
-                if (face[i][2] < transformedNormals.size())
-                    attr.normal = transformedNormals[face[i][2]];
-                else
-                    attr.normal = faceNormal;
+                    clipVerts[i] = wsToClip(wsPos, projView, attr);
+                }
 
-                clipVerts[i] = wsToClip(wsPos, projView, attr);
+                // Clip against near plane and project
+                std::array<std::array<ProjectedVertex<NumericT>, 3>, 2> clipped;
+                std::size_t count = gt::clipAndProject(clipVerts, sceneCache.camera, clipped);
+                for (std::size_t t = 0; t < count; ++t)
+                    out.push_back(clipped[t]);
             }
+        };
 
-            // Clip against near plane and project
-            std::array<std::array<ProjectedVertex<NumericT>, 3>, 2> out;
-            std::size_t count = gt::clipAndProject(clipVerts, sceneCache.camera, out);
-            for (std::size_t t = 0; t < count; ++t)
-                projected.push_back(out[t]);
-        }
+        {
+            SC_PROFILE_STAGE(ClipProject);
+            const std::size_t first = projected.size();
+            const std::size_t faceCount = model.faces().size();
+            const std::size_t chunks = internal::chunkCount(pool, faceCount);
 
-        gt::rasterizeTiled(projected, shader, sceneCache);
+            if (chunks <= 1)
+            {
+                projectFaces(0, faceCount, projected);
+            }
+            else
+            {
+                // each chunk projects into its own list; concatenating the
+                // lists in chunk order gives the serial triangle order
+                chunkTriangles.resize(chunks);
+                internal::forEachChunk(pool, faceCount, [&](std::size_t chunk, std::size_t begin, std::size_t end)
+                {
+                    chunkTriangles[chunk].clear();
+                    projectFaces(begin, end, chunkTriangles[chunk]);
+                });
+
+                chunkStart.assign(chunks + 1, first);
+                for (std::size_t c = 0; c < chunks; ++c)
+                    chunkStart[c + 1] = chunkStart[c] + chunkTriangles[c].size();
+
+                projected.resize(chunkStart[chunks]);
+                pool->parallelFor(chunks, [&](std::size_t chunk, std::size_t)
+                {
+                    std::copy(chunkTriangles[chunk].begin(), chunkTriangles[chunk].end(),
+                              projected.begin() + static_cast<std::ptrdiff_t>(chunkStart[chunk]));
+                });
+            }
+            modelIds.resize(projected.size(), modelId);
+        }
     }
+
+    gt::rasterizeTiled(projected, modelIds, shaders, sceneCache, &scratch.bins);
+    // the shaders refer to the models; keep only the capacity
+    shaders.clear();
 }
 
 template<typename NumericT>
@@ -287,7 +416,7 @@ template<typename NumericT,
     typename EachFrameModelUpdate = decltype([](std::size_t, std::size_t){ }),
     typename CustomDrawer =
         decltype([](std::size_t, std::size_t, sc::GLFWRenderer&, const sc::utils::Mat<NumericT, 4, 4>&,
-            const std::vector<std::vector<NumericT>>&){ }),
+            const DepthBuffer<NumericT>&){ }),
     typename MakeShader = internal::DefaultShaderFactory<NumericT>>
 void initMrcRender(sc::Camera<NumericT, sc::VecArray>& camera,
                    const std::vector<Model<NumericT>>& models,
@@ -297,40 +426,54 @@ void initMrcRender(sc::Camera<NumericT, sc::VecArray>& camera,
                    const std::vector<std::pair<std::vector<int>, std::function<void()>>>& customKeyHandlers = {},
                    sc::utils::Vec<int, 2> windowResolution = sc::utils::Vec<int, 2>{-1, -1},
                    unsigned int targetFrameRateMs = 60,
-                   MakeShader makeShader = { })
+                   MakeShader makeShader = { },
+                   const sc::RenderParams& params = { })
 {
     using Mat4 = sc::utils::Mat<NumericT, 4, 4>;
 
-    std::vector zBuffer(
-        static_cast<std::size_t>(camera.res()[1]),
-        std::vector(
-            static_cast<std::size_t>(camera.res()[0]),
-          std::numeric_limits<float>::max()
-        )
-    );
-
-    const auto usc = [&zBuffer, &camera] {
-        for (auto& buf : zBuffer)
-            std::fill(buf.begin(), buf.end(), std::numeric_limits<float>::max());
-        Mat4 view = mrc::getViewMatrix(camera);
-        Mat4 proj = mrc::getProjectionMatrix(camera);
+    DepthBuffer<NumericT> zBuffer(
+        static_cast<std::size_t>(camera.res()[0]),
+        static_cast<std::size_t>(camera.res()[1]));
+
+    const auto usc = [](const sc::Camera<NumericT, sc::VecArray>& frameCamera) {
+        Mat4 view = mrc::getViewMatrix(frameCamera);
+        Mat4 proj = mrc::getProjectionMatrix(frameCamera);
         return std::pair{view, proj};
     };
 
-    auto ff = [&efmu, &usc, &cd, &models, &camera, &zBuffer, &lights, makeShader = std::move(makeShader)](
+    internal::SceneTracker<NumericT> tracker;
+    internal::FrameScratch<NumericT, internal::ShaderOf<NumericT, MakeShader>> scratch;
+    sc::Camera<NumericT, sc::VecArray> scaledCamera(camera);
+    sc::utils::ThreadPool pool(params.threadCount);
+
+    auto ff = [&efmu, &usc, &cd, &models, &camera, &scaledCamera, &zBuffer, &lights, &tracker, &scratch, &pool,
+               clearEachFrame = params.clearEachFrame, makeShader = std::move(makeShader)](
         sc::GLFWRenderer& renderer, std::size_t frame, std::size_t time) mutable
     {
+        {
+            SC_PROFILE_STAGE(Update);
+            efmu(frame, time);
+        }
+        const auto& frameCamera = internal::frameCamera(camera, renderer, scaledCamera);
         internal::SceneCache<NumericT> sceneCache{
             renderer,
-            camera,
+            frameCamera,
             zBuffer,
             lights,
+            &pool,
         };
-        auto [view, proj] = usc();
+        auto [view, proj] = usc(frameCamera);
         auto viewProj = proj * view;
-        efmu(frame, time);
-        internal::renderSingleFrame(models, viewProj, makeShader, sceneCache);
-        cd(frame, time, renderer, viewProj, zBuffer);
+        if (tracker.beginFrame(camera, models, lights, renderer))
+        {
+            if (clearEachFrame)
+                renderer.clear();
+            zBuffer.clear();
+            internal::renderSingleFrame(models, viewProj, makeShader, sceneCache, scratch);
+            tracker.rasterized(renderer);
+        }
+        if (internal::runCustomDrawer(cd, frame, time, renderer, viewProj, zBuffer))
+            tracker.forceRedraw();
     };
 
     constexpr NumericT stepSize = .5;
@@ -352,7 +495,83 @@ void initMrcRender(sc::Camera<NumericT, sc::VecArray>& camera,
       camera.rot()[1] += dx * rotSize;
     };
 
-    sc::initPerFrameRender(camera, ff, {}, keyHandlers, mouseHandler, windowResolution, targetFrameRateMs);
+    // unchanged frames are overwritten by the kept image, so ff clears
+    // only the frames it rasterizes
+    auto frameParams = params;
+    frameParams.clearEachFrame = false;
+    sc::initPerFrameRender(camera, ff, {}, keyHandlers, mouseHandler, windowResolution, targetFrameRateMs,
+                           frameParams);
+}
+
+/// initMrcRender() without a window: renders offline.frameCount frames
+/// headless on a fixed synthetic timestep, see sc::renderPerFrameOffline().
+/// efmu and cd run at the same points of the frame as in initMrcRender();
+/// cd receives the frame as sc::FrameBuffer&, which also binds the
+/// GLFWRenderer of the windowed mode. Tiles are rasterized on
+/// params.threadCount threads, but every pixel sees its triangles in
+/// submission order and the frame time is synthetic, so equal inputs give
+/// bit-identical frames.
+/// Like the windowed entry points it re-rasterizes only when the scene
+/// changed, see internal::SceneTracker; cd returning true forces it.
+template<typename NumericT,
+    typename EachFrameModelUpdate = decltype([](std::size_t, std::size_t){ }),
+    typename CustomDrawer =
+        decltype([](std::size_t, std::size_t, sc::FrameBuffer&, const sc::utils::Mat<NumericT, 4, 4>&,
+            const DepthBuffer<NumericT>&){ }),
+    typename MakeShader = internal::DefaultShaderFactory<NumericT>>
+void renderMrcOffline(sc::Camera<NumericT, sc::VecArray>& camera,
+                      const std::vector<Model<NumericT>>& models,
+                      const std::vector<LightSource<NumericT>>& lights,
+                      EachFrameModelUpdate efmu = { },
+                      CustomDrawer cd = { },
+                      const sc::OfflineParams& offline = { },
+                      const sc::RenderParams& params = { },
+                      MakeShader makeShader = { })
+{
+    using Mat4 = sc::utils::Mat<NumericT, 4, 4>;
+
+    DepthBuffer<NumericT> zBuffer(
+        static_cast<std::size_t>(camera.res()[0]),
+        static_cast<std::size_t>(camera.res()[1]));
+
+    internal::SceneTracker<NumericT> tracker;
+    internal::FrameScratch<NumericT, internal::ShaderOf<NumericT, MakeShader>> scratch;
+    sc::utils::ThreadPool pool(params.threadCount);
+
+    auto ff = [&efmu, &cd, &models, &camera, &zBuffer, &lights, &makeShader, &tracker, &scratch, &pool,
+               clearEachFrame = params.clearEachFrame](
+        sc::FrameBuffer& renderer, std::size_t frame, std::size_t time)
+    {
+        internal::SceneCache<NumericT> sceneCache{
+            renderer,
+            camera,
+            zBuffer,
+            lights,
+            &pool,
+        };
+
+        {
+            SC_PROFILE_STAGE(Update);
+            efmu(frame, time);
+        }
+        Mat4 view = getViewMatrix(camera);
+        Mat4 proj = getProjectionMatrix(camera);
+        auto viewProj = proj * view;
+        if (tracker.beginFrame(camera, models, lights, renderer))
+        {
+            if (clearEachFrame)
+                renderer.clear();
+            zBuffer.clear();
+            internal::renderSingleFrame(models, viewProj, makeShader, sceneCache, scratch);
+            tracker.rasterized(renderer);
+        }
+        if (internal::runCustomDrawer(cd, frame, time, renderer, viewProj, zBuffer))
+            tracker.forceRedraw();
+    };
+
+    auto frameParams = params;
+    frameParams.clearEachFrame = false;
+    sc::renderPerFrameOffline(camera, ff, { }, offline, frameParams);
 }
 
 
@@ -360,7 +579,7 @@ template<typename NumericT,
     typename EachFrameModelUpdate = decltype([](std::size_t, std::size_t){ }),
     typename CustomDrawer =
         decltype([](std::size_t, std::size_t, sc::GLFWRenderer&, const sc::utils::Mat<NumericT, 4, 4>&,
-            const std::vector<std::vector<NumericT>>&){ }),
+            const DepthBuffer<NumericT>&){ }),
     typename MakeShader = internal::DefaultShaderFactory<NumericT>>
 auto makeMrcWindow(sc::Camera<NumericT, sc::VecArray>& camera,
                    const std::vector<Model<NumericT>>& models,
@@ -371,41 +590,49 @@ auto makeMrcWindow(sc::Camera<NumericT, sc::VecArray>& camera,
                    sc::utils::Vec<int, 2> windowResolution = sc::utils::Vec<int, 2>{-1, -1},
                    unsigned int targetFrameRateMs = 60,
                    const char* title = "Model Renderer",
-                   MakeShader makeShader = { })
+                   MakeShader makeShader = { },
+                   const sc::RenderParams& params = { })
 {
     using Mat4 = sc::utils::Mat<NumericT, 4, 4>;
 
-    auto zBuffer = std::make_shared<std::vector<std::vector<NumericT>>>(
-        static_cast<std::size_t>(camera.res()[1]),
-        std::vector<NumericT>(
-            static_cast<std::size_t>(camera.res()[0]),
-            std::numeric_limits<NumericT>::max()
-        )
-    );
+    auto zBuffer = std::make_shared<DepthBuffer<NumericT>>(
+        static_cast<std::size_t>(camera.res()[0]),
+        static_cast<std::size_t>(camera.res()[1]));
 
     auto ff = [&models, &camera, zBuffer,
                &lights,
-               efmu = std::move(efmu), cd = std::move(cd),
+               tracker = std::make_shared<internal::SceneTracker<NumericT>>(),
+               scratch = std::make_shared<internal::FrameScratch<NumericT, internal::ShaderOf<NumericT, MakeShader>>>(),
+               pool = sc::utils::acquireThreadPool(params.threadCount),
+               scaledCamera = std::make_shared<sc::Camera<NumericT, sc::VecArray>>(camera),
+               clearEachFrame = params.clearEachFrame,
+               cd = std::move(cd),
                makeShader = std::move(makeShader)](
         sc::GLFWRenderer& renderer, std::size_t frame, std::size_t time) mutable
     {
-        for (auto& buf : *zBuffer)
-            std::fill(buf.begin(), buf.end(), std::numeric_limits<NumericT>::max());
-
+        const auto& frameCamera = internal::frameCamera(camera, renderer, *scaledCamera);
         internal::SceneCache<NumericT> sceneCache{
             renderer,
-            camera,
+            frameCamera,
             *zBuffer,
             lights,
+            pool.get(),
         };
 
-        Mat4 view = getViewMatrix(camera);
-        Mat4 proj = getProjectionMatrix(camera);
+        Mat4 view = getViewMatrix(frameCamera);
+        Mat4 proj = getProjectionMatrix(frameCamera);
         auto viewProj = proj * view;
 
-        efmu(frame, time);
-        internal::renderSingleFrame(models, viewProj, makeShader, sceneCache);
-        cd(frame, time, renderer, viewProj, *zBuffer);
+        if (tracker->beginFrame(camera, models, lights, renderer))
+        {
+            if (clearEachFrame)
+                renderer.clear();
+            zBuffer->clear();
+            internal::renderSingleFrame(models, viewProj, makeShader, sceneCache, *scratch);
+            tracker->rasterized(renderer);
+        }
+        if (internal::runCustomDrawer(cd, frame, time, renderer, viewProj, *zBuffer))
+            tracker->forceRedraw();
     };
 
     constexpr NumericT stepSize = .05;
@@ -427,9 +654,14 @@ auto makeMrcWindow(sc::Camera<NumericT, sc::VecArray>& camera,
       camera.rot()[1] += dx * rotSize;
     };
 
+    // efmu runs as the window's frame update: on the main thread, after the
+    // frame is presented, never concurrently with another window's render
+    // or update. It prepares the models for the next frame.
+    auto frameParams = params;
+    frameParams.clearEachFrame = false;
     return sc::makePerFrameWindow(camera, std::move(ff),
-        [](std::size_t, std::size_t){},
-        keyHandlers, mouseHandler, windowResolution, targetFrameRateMs, title);
+        std::move(efmu),
+        keyHandlers, mouseHandler, windowResolution, targetFrameRateMs, title, frameParams);
 }
 
 } 
@@ -32,6 +32,8 @@ struct Model
     const sc::utils::Vec<NumericT, 3>& rot() const { return geometry.rot(); }
     sc::utils::Vec<NumericT, 3>& rot() { return geometry.rot(); }
 
+    void markDirty() { geometry.markDirty(); }
+
     std::array<sc::utils::Vec<NumericT, 3>, 3> getPolygon(
         std::size_t faceIdx,
         const std::vector<sc::utils::Vec<NumericT, 3>>& vertSource) const
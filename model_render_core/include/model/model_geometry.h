@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utils/revision.h>
 #include <utils/vec.h>
 
 namespace mrc {
@@ -28,7 +29,8 @@ public:
         _normals(model._normals),
         _faces(model._faces),
         _pos(model._pos),
-        _rot(model._rot)
+        _rot(model._rot),
+        _revision(model._revision)
     {}
 
     ModelGeometry(ModelGeometry&& model) noexcept:
@@ -37,7 +39,8 @@ public:
         _normals(std::move(model._normals)),
         _faces(std::move(model._faces)),
         _pos(std::move(model._pos)),
-        _rot(std::move(model._rot))
+        _rot(std::move(model._rot)),
+        _revision(model._revision)
     {}
 
     ModelGeometry& operator=(const ModelGeometry& model) = default;
@@ -48,13 +51,17 @@ public:
     [[nodiscard]] const std::vector<Face>& faces() const {return _faces;}
     const sc::utils::Vec<NumericT, 3>& pos() const {return _pos;}
     const sc::utils::Vec<NumericT, 3>& rot() const {return _rot;}
-
-    std::vector<sc::utils::Vec<NumericT, 3>>& verticies() {return _verticies;}
-    std::vector<sc::utils::Vec<NumericT, 2>>& uv() {return _uv;}
-    std::vector<sc::utils::Vec<NumericT, 3>>& normals() {return _normals;}
-    [[nodiscard]] std::vector<Face>& faces() {return _faces;}
-    sc::utils::Vec<NumericT, 3>& pos() {return _pos;}
-    sc::utils::Vec<NumericT, 3>& rot() {return _rot;}
+    /// Changes on every mutable accessor call.
+    const sc::utils::Revision& revision() const {return _revision;}
+    /// Records an edit made through a reference held across frames.
+    void markDirty() {_revision.touch();}
+
+    std::vector<sc::utils::Vec<NumericT, 3>>& verticies() {_revision.touch(); return _verticies;}
+    std::vector<sc::utils::Vec<NumericT, 2>>& uv() {_revision.touch(); return _uv;}
+    std::vector<sc::utils::Vec<NumericT, 3>>& normals() {_revision.touch(); return _normals;}
+    [[nodiscard]] std::vector<Face>& faces() {_revision.touch(); return _faces;}
+    sc::utils::Vec<NumericT, 3>& pos() {_revision.touch(); return _pos;}
+    sc::utils::Vec<NumericT, 3>& rot() {_revision.touch(); return _rot;}
 
     std::array<sc::utils::Vec<NumericT, 3>, 3> getPolygon(std::size_t faceIdx,
         const std::vector<sc::utils::Vec<NumericT, 3>>& vertSource) const {
@@ -73,6 +80,8 @@ private:
 
     sc::utils::Vec<NumericT, 3> _pos;
     sc::utils::Vec<NumericT, 3> _rot;
+
+    sc::utils::Revision _revision;
 };
 
 }
\ No newline at end of file
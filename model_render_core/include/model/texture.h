@@ -83,8 +83,9 @@ public:
         float ftx = static_cast<float>(tx);
         float fty = static_cast<float>(ty);
 
-        return c00 * (1.f - ftx) * (1.f - fty) + c10 * ftx * (1.f - fty)
-             + c01 * (1.f - ftx) * fty + c11 * ftx * fty;
+        using sc::utils::lazy;
+        return lazy(c00) * (1.f - ftx) * (1.f - fty) + lazy(c10) * ftx * (1.f - fty)
+             + lazy(c01) * (1.f - ftx) * fty + lazy(c11) * ftx * fty;
     }
 
     [[nodiscard]] std::size_t width()  const { return _width;  }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "depth_buffer.h"
 #include "light_source.h"
 
-#include "glfw_render.h"
+#include "frame_buffer.h"
 #include "window.h"
 #include "camera/camera.h"
+#include "utils/thread_pool.h"
 
 
 namespace mrc::internal
@@ -13,10 +15,12 @@ namespace mrc::internal
 template<typename NumericT>
 struct SceneCache
 {
-    sc::GLFWRenderer& renderer;
+    sc::FrameBuffer& renderer;
     const sc::Camera<NumericT, sc::VecArray>& camera;
-    std::vector<std::vector<NumericT>>& zBuffer;
+    DepthBuffer<NumericT>& zBuffer;
     const std::vector<LightSource<NumericT>>& lights;
+    /// Rasterizes the tiles in parallel when set; null rasterizes serially.
+    sc::utils::ThreadPool* pool = nullptr;
 };
 
 } // namespace mrc::internal
\ No newline at end of file
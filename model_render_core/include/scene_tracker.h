@@ -0,0 +1,145 @@
+#pragma once
+
+#include "light_source.h"
+#include "model/model.h"
+
+#include "frame_buffer.h"
+#include "camera/camera.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace mrc::internal
+{
+
+/// Skips rasterization of frames whose camera, model transforms, geometry,
+/// materials and lights equal those of the previous frame. Change
+/// detection uses the revisions of Camera and ModelGeometry plus copies of
+/// the materials and lights. Edits written through a reference kept from
+/// an earlier frame bypass the revisions and need markDirty() on the
+/// owner, or forceRedraw().
+///
+/// Animated scenes pay nothing: the rasterized image is kept only once a
+/// frame repeats its predecessor, so the first still frame is rasterized
+/// a second time and every following one is a copy.
+template<typename NumericT>
+class SceneTracker
+{
+public:
+    /// Rasterizes the next frame even when nothing changed.
+    void forceRedraw() { _valid = false; }
+
+    /// Decides for the frame about to be drawn into @p frame. Returns false
+    /// when the kept image was copied into @p frame, true when the caller
+    /// must rasterize and then call rasterized().
+    bool beginFrame(const sc::Camera<NumericT, sc::VecArray>& camera,
+                    const std::vector<Model<NumericT>>& models,
+                    const std::vector<LightSource<NumericT>>& lights,
+                    sc::FrameBuffer& frame)
+    {
+        const bool same = _valid && sameScene(camera, models, lights);
+        record(camera, models, lights);
+
+        if (!same)
+        {
+            _stored = false;
+            _store = false;
+            return true;
+        }
+
+        if (_stored && _image->getRenderWidth() == frame.getRenderWidth()
+                    && _image->getRenderHeight() == frame.getRenderHeight())
+        {
+            frame.copyContents(*_image);
+            return false;
+        }
+
+        _store = true;
+        return true;
+    }
+
+    /// Called after rasterizing, before the custom drawer touches @p frame.
+    void rasterized(const sc::FrameBuffer& frame)
+    {
+        if (!_store)
+            return;
+
+        if (!_image || _image->getRenderWidth() != frame.getRenderWidth()
+                    || _image->getRenderHeight() != frame.getRenderHeight())
+        {
+            _image = std::make_unique<sc::FrameBuffer>(
+                static_cast<int>(frame.getRenderWidth()),
+                static_cast<int>(frame.getRenderHeight()),
+                frame.params());
+        }
+        _image->copyContents(frame);
+        _stored = true;
+        _store = false;
+    }
+
+private:
+    bool _valid = false;
+    bool _stored = false;
+    bool _store = false;
+    std::uint64_t _camera = 0;
+    std::vector<std::uint64_t> _models;
+    std::vector<Material<NumericT>> _materials;
+    std::vector<LightSource<NumericT>> _lights;
+    std::unique_ptr<sc::FrameBuffer> _image;
+
+    bool sameScene(const sc::Camera<NumericT, sc::VecArray>& camera,
+                   const std::vector<Model<NumericT>>& models,
+                   const std::vector<LightSource<NumericT>>& lights) const
+    {
+        if (camera.revision().value() != _camera || models.size() != _models.size())
+            return false;
+
+        for (std::size_t i = 0; i < models.size(); ++i)
+        {
+            if (models[i].geometry.revision().value() != _models[i])
+                return false;
+        }
+
+        auto same = [](const auto& a, const auto& b) {
+            return std::equal(a.begin(), a.end(), b.begin());
+        };
+        for (std::size_t i = 0; i < models.size(); ++i)
+        {
+            // textures are immutable, so comparing the pointers suffices
+            const auto& a = models[i].material;
+            const auto& b = _materials[i];
+            if (!same(a.baseColor, b.baseColor) || a.diffuseMap != b.diffuseMap
+                || a.normalMap != b.normalMap || a.roughnessMap != b.roughnessMap
+                || a.ambient != b.ambient || a.specular != b.specular
+                || a.shininess != b.shininess)
+                return false;
+        }
+
+        return std::equal(lights.begin(), lights.end(), _lights.begin(), _lights.end(),
+            [&same](const LightSource<NumericT>& a, const LightSource<NumericT>& b) {
+                return same(a.position, b.position) && same(a.direction, b.direction)
+                    && same(a.color, b.color) && a.intensity == b.intensity;
+            });
+    }
+
+    void record(const sc::Camera<NumericT, sc::VecArray>& camera,
+                const std::vector<Model<NumericT>>& models,
+                const std::vector<LightSource<NumericT>>& lights)
+    {
+        _valid = true;
+        _camera = camera.revision().value();
+        _models.resize(models.size());
+        _materials.resize(models.size());
+        for (std::size_t i = 0; i < models.size(); ++i)
+        {
+            _models[i] = models[i].geometry.revision().value();
+            _materials[i] = models[i].material;
+        }
+        _lights = lights;
+    }
+};
+
+} // namespace mrc::internal
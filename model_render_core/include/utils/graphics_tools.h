@@ -1,5 +1,5 @@
 #pragma once
-#include "glfw_render.h"
+#include "frame_buffer.h"
 #include "point_projection.h"
 #include "scene_cache.h"
 
@@ -8,7 +8,7 @@ namespace mrc::gt
 
 template<typename NumericT>
 void drawLine(
-    sc::GLFWRenderer& renderer,
+    sc::FrameBuffer& renderer,
     const sc::utils::Vec<NumericT, 2>& a,
     const sc::utils::Vec<NumericT, 2>& b,
     const sc::utils::Vec<NumericT, 3>& color)
@@ -57,7 +57,7 @@ NumericT edgeFunction(
 
 template<typename NumericT>
 void drawTriangle(
-    sc::GLFWRenderer& renderer,
+    sc::FrameBuffer& renderer,
     const sc::utils::Vec<NumericT, 2>& v0,
     const sc::utils::Vec<NumericT, 2>& v1,
     const sc::utils::Vec<NumericT, 2>& v2,
@@ -238,7 +238,8 @@ void rasterizeTriangle(
                     w2 * tri[2].invW;
                 NumericT currentZ = NumericT(1) / baryInvW;
 
-                if (currentZ > 0 && currentZ < zBuffer[y][x])
+                NumericT& depth = zBuffer.at(x, y);
+                if (currentZ > 0 && currentZ < depth)
                 {
                     
                     auto interpAttr = (a0 * w0 + a1 * w1 + a2 * w2) * currentZ;
@@ -256,7 +257,7 @@ void rasterizeTriangle(
 
                     auto color = shader(frag);
 
-                    zBuffer[y][x] = currentZ;
+                    depth = currentZ;
                     renderer.setPixel(x, y, color);
                 }
             }
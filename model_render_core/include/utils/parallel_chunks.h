@@ -0,0 +1,50 @@
+#pragma once
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace mrc::internal
+{
+
+/// Smallest slice of vertices, faces or triangles worth a parallel task.
+constexpr std::size_t MIN_CHUNK_SIZE = 4096;
+
+/// Number of slices forEachChunk() cuts @p count items into: one without
+/// a pool, otherwise up to four per thread so stealing can even them out.
+inline std::size_t chunkCount(const sc::utils::ThreadPool* pool, std::size_t count)
+{
+    if (count == 0)
+        return 0;
+    if (!pool || pool->size() == 1)
+        return 1;
+    const std::size_t chunks = (count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE;
+    return std::min(chunks, pool->size() * 4);
+}
+
+/// Calls fn(chunk, begin, end) for the chunkCount() consecutive slices of
+/// [0, count), in parallel on @p pool when there is more than one. Chunk
+/// indices follow the item order, so per-chunk outputs concatenated by
+/// index keep the serial order.
+template<typename Fn>
+void forEachChunk(sc::utils::ThreadPool* pool, std::size_t count, Fn&& fn)
+{
+    const std::size_t chunks = chunkCount(pool, count);
+    if (chunks == 0)
+        return;
+    if (chunks == 1)
+    {
+        fn(std::size_t(0), std::size_t(0), count);
+        return;
+    }
+
+    const std::size_t size = (count + chunks - 1) / chunks;
+    pool->parallelFor(chunks, [&fn, size, count](std::size_t chunk, std::size_t)
+    {
+        const std::size_t begin = std::min(chunk * size, count);
+        fn(chunk, begin, std::min(begin + size, count));
+    });
+}
+
+} // namespace mrc::internal
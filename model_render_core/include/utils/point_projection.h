@@ -35,12 +35,13 @@ struct VertexAttributes {
     sc::utils::Vec<NumericT, 3> bitangent{};
 
     VertexAttributes lerp(const VertexAttributes& o, NumericT t) const {
+        using sc::utils::lazy;
         return VertexAttributes{
-            uv        + (o.uv        - uv)        * t,
-            normal    + (o.normal    - normal)     * t,
-            worldPos  + (o.worldPos  - worldPos)   * t,
-            tangent   + (o.tangent   - tangent)    * t,
-            bitangent + (o.bitangent - bitangent)  * t
+            lazy(uv)        + (lazy(o.uv)        - uv)        * t,
+            lazy(normal)    + (lazy(o.normal)    - normal)    * t,
+            lazy(worldPos)  + (lazy(o.worldPos)  - worldPos)  * t,
+            lazy(tangent)   + (lazy(o.tangent)   - tangent)   * t,
+            lazy(bitangent) + (lazy(o.bitangent) - bitangent) * t
         };
     }
 
@@ -1,19 +1,266 @@
 #pragma once
 
 #include "graphics_tools.h"
+#include "parallel_chunks.h"
+#include "utils/profiler.h"
 
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 
 namespace mrc::gt
 {
 
-/// Default tile size (pixels).  32x32 tile z-buffer (4 KB for float)
-/// must fit comfortably in L1 cache.
-constexpr int TILE_SIZE = 32;
+/// Writes fragments straight into the framebuffer and z-buffer of a
+/// SceneCache, for rects of any size.
+template<typename NumericT>
+struct SceneTarget
+{
+    sc::FrameBuffer& renderer;
+    DepthBuffer<NumericT>& zBuffer;
+
+    NumericT& depth(int x, int y)
+    {
+        return zBuffer.at(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+    }
+
+    void write(int x, int y, const sc::utils::Vec<float, 3>& color)
+    {
+        renderer.setPixel(static_cast<std::size_t>(x), static_cast<std::size_t>(y), color);
+    }
+};
+
+/// Writes fragments of one tile: depth into the tile's block of the
+/// DepthBuffer, colors straight into the framebuffer.
+template<typename NumericT>
+struct TileTarget
+{
+    sc::FrameBuffer& renderer;
+    NumericT* depths = nullptr;
+    int x0 = 0;
+    int y0 = 0;
+
+    NumericT& depth(int x, int y) { return depths[(y - y0) * TILE_SIZE + (x - x0)]; }
+
+    void write(int x, int y, const sc::utils::Vec<float, 3>& color)
+    {
+        renderer.setPixel(static_cast<std::size_t>(x), static_cast<std::size_t>(y), color);
+    }
+
+    void begin(NumericT* tileDepths, int tx0, int ty0, int, int)
+    {
+        depths = tileDepths;
+        x0 = tx0;
+        y0 = ty0;
+    }
+};
 
+/// TileTarget of one thread of the parallel tile loop. Depth blocks are
+/// whole cache lines and are written in place, but framebuffer rows share
+/// cache lines with neighbouring tiles, so colors land in a private copy
+/// that store() flushes once the tile is done.
+template<typename NumericT>
+struct alignas(64) BufferedTileTarget
+{
+    static constexpr int area = TILE_SIZE * TILE_SIZE;
+
+    alignas(64) std::array<sc::utils::Vec<float, 3>, area> colors;
+    alignas(64) std::array<bool, area> written;
+    NumericT* depths = nullptr;
+    int x0 = 0;
+    int y0 = 0;
+    int width = 0;
+    int height = 0;
+
+    NumericT& depth(int x, int y) { return depths[(y - y0) * TILE_SIZE + (x - x0)]; }
+
+    void write(int x, int y, const sc::utils::Vec<float, 3>& color)
+    {
+        const int i = (y - y0) * TILE_SIZE + (x - x0);
+        colors[i] = color;
+        written[i] = true;
+    }
+
+    void begin(NumericT* tileDepths, int tx0, int ty0, int tx1, int ty1)
+    {
+        depths = tileDepths;
+        x0 = tx0;
+        y0 = ty0;
+        width = tx1 - tx0;
+        height = ty1 - ty0;
+        written.fill(false);
+    }
+
+    /// Writes the shaded pixels as runs, leaving pixels no fragment
+    /// reached untouched.
+    void store(sc::FrameBuffer& renderer) const
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            const int row = y * TILE_SIZE;
+            for (int x = 0; x < width; )
+            {
+                if (!written[row + x])
+                {
+                    ++x;
+                    continue;
+                }
+                int end = x + 1;
+                while (end < width && written[row + end])
+                    ++end;
+                renderer.writeSpan(static_cast<std::size_t>(x0 + x), static_cast<std::size_t>(y0 + y),
+                                   &colors[row + x], static_cast<std::size_t>(end - x));
+                x = end;
+            }
+        }
+    }
+};
+
+/// Hierarchical depth of the tile being rasterized: the farthest depth of
+/// the tile and of each of its 8x8 blocks. A triangle no nearer than that
+/// cannot pass the depth test there, so rasterize() drops it for the tile
+/// or for the blocks, before any per-pixel work.
+///
+/// Depth only decreases while a tile is drawn, so a block's max is exact
+/// or too far, never too near. Blocks a triangle was drawn over are only
+/// marked dirty and rescanned when next tested; the tile max is refreshed
+/// with them.
+template<typename NumericT>
+class TileHiZ
+{
+public:
+    static constexpr int BLOCK_SIZE = 8;
+    static constexpr int BLOCKS_PER_ROW = TILE_SIZE / BLOCK_SIZE;
+
+    /// Starts tile @p depths; @p cleared tells that it is all max().
+    void begin(const NumericT* depths, bool cleared)
+    {
+        _depths = depths;
+        _blockMax.fill(std::numeric_limits<NumericT>::max());
+        _tileMax = std::numeric_limits<NumericT>::max();
+        _dirty = cleared ? 0u : ~0u;
+    }
+
+    /// Calls rasterize(rx0, ry0, rx1, ry1) for the parts of tile rect
+    /// [x0, x1) x [y0, y1) where @p tri may pass the depth test: the whole
+    /// rect when no 8x8 block under the triangle rejects it, otherwise
+    /// one rect per run of accepted blocks in each block row.
+    template<typename Rasterize>
+    void rasterize(const std::array<internal::ProjectedVertex<NumericT>, 3>& tri,
+                   int x0, int y0, int x1, int y1,
+                   Rasterize&& rasterize)
+    {
+        const auto& v0 = tri[0].pixel;
+        const auto& v1 = tri[1].pixel;
+        const auto& v2 = tri[2].pixel;
+        const int minX = std::max(x0, static_cast<int>(std::min({v0[0], v1[0], v2[0]})));
+        const int maxX = std::min(x1 - 1, static_cast<int>(std::max({v0[0], v1[0], v2[0]})));
+        const int minY = std::max(y0, static_cast<int>(std::min({v0[1], v1[1], v2[1]})));
+        const int maxY = std::min(y1 - 1, static_cast<int>(std::max({v0[1], v1[1], v2[1]})));
+        if (minX > maxX || minY > maxY)
+            return;
+
+        const NumericT zNear = nearestDepth(tri);
+        if (zNear >= _tileMax)
+            return;
+
+        const int bx0 = (minX - x0) / BLOCK_SIZE;
+        const int bx1 = (maxX - x0) / BLOCK_SIZE;
+        const int by0 = (minY - y0) / BLOCK_SIZE;
+        const int by1 = (maxY - y0) / BLOCK_SIZE;
+
+        std::uint32_t covered = 0;
+        std::uint32_t accepted = 0;
+        for (int by = by0; by <= by1; ++by)
+        {
+            for (int bx = bx0; bx <= bx1; ++bx)
+            {
+                const int block = by * BLOCKS_PER_ROW + bx;
+                covered |= 1u << block;
+                if (zNear < blockMax(block))
+                    accepted |= 1u << block;
+            }
+        }
+        refreshTileMax();
+
+        if (accepted == covered)
+        {
+            rasterize(x0, y0, x1, y1);
+            _dirty |= covered;
+            return;
+        }
+
+        for (int by = by0; by <= by1; ++by)
+        {
+            const int ry0 = y0 + by * BLOCK_SIZE;
+            const int ry1 = std::min(ry0 + BLOCK_SIZE, y1);
+            for (int bx = bx0; bx <= bx1; )
+            {
+                if (!(accepted & (1u << (by * BLOCKS_PER_ROW + bx))))
+                {
+                    ++bx;
+                    continue;
+                }
+                int end = bx + 1;
+                while (end <= bx1 && (accepted & (1u << (by * BLOCKS_PER_ROW + end))))
+                    ++end;
+                rasterize(x0 + bx * BLOCK_SIZE, ry0, std::min(x0 + end * BLOCK_SIZE, x1), ry1);
+                bx = end;
+            }
+        }
+        _dirty |= accepted;
+    }
+
+private:
+    static_assert(BLOCKS_PER_ROW * BLOCKS_PER_ROW <= 32, "block mask must fit 32 bits");
+
+    const NumericT* _depths = nullptr;
+    std::array<NumericT, BLOCKS_PER_ROW * BLOCKS_PER_ROW> _blockMax{ };
+    NumericT _tileMax = std::numeric_limits<NumericT>::max();
+    std::uint32_t _dirty = 0;
+
+    /// Lower bound of the depth of every fragment of @p tri: 1/w is affine
+    /// on screen, so no fragment is nearer than the vertex of largest 1/w.
+    /// The bound is pulled closer by 1/1024 to absorb the rounding of the
+    /// incremental edge functions; 0 (never rejecting) when a vertex has
+    /// w <= 0.
+    static NumericT nearestDepth(const std::array<internal::ProjectedVertex<NumericT>, 3>& tri)
+    {
+        const NumericT minInvW = std::min({tri[0].invW, tri[1].invW, tri[2].invW});
+        const NumericT maxInvW = std::max({tri[0].invW, tri[1].invW, tri[2].invW});
+        if (!(minInvW > NumericT(0)))
+            return NumericT(0);
+        return (NumericT(1) - NumericT(1) / NumericT(1024)) / maxInvW;
+    }
+
+    NumericT blockMax(int block)
+    {
+        if (_dirty & (1u << block))
+        {
+            const NumericT* row = _depths
+                + (block / BLOCKS_PER_ROW) * BLOCK_SIZE * TILE_SIZE
+                + (block % BLOCKS_PER_ROW) * BLOCK_SIZE;
+            NumericT m = row[0];
+            for (int y = 0; y < BLOCK_SIZE; ++y, row += TILE_SIZE)
+                for (int x = 0; x < BLOCK_SIZE; ++x)
+                    m = std::max(m, row[x]);
+            _blockMax[block] = m;
+            _dirty &= ~(1u << block);
+        }
+        return _blockMax[block];
+    }
 
+    /// Tile max from the block maxima; dirty blocks keep their old, too
+    /// far value, which leaves the tile max valid.
+    void refreshTileMax()
+    {
+        _tileMax = *std::max_element(_blockMax.begin(), _blockMax.end());
+    }
+};
 
 /// Clip a triangle against the near plane and project the result.
 /// Writes 0, 1, or 2 projected triangles into @p out.
@@ -76,16 +323,16 @@ std::size_t clipAndProject(
     return 1;
 }
 
-template<typename NumericT, typename FragmentShader>
+/// Rasterizes @p tri clipped to [rx0, rx1) x [ry0, ry1) into @p target,
+/// a SceneTarget or a tile target covering the rect.
+template<typename NumericT, typename FragmentShader, typename Target>
 void rasterizeTriangleInRect(
     const std::array<internal::ProjectedVertex<NumericT>, 3>& tri,
     const FragmentShader& shader,
-    internal::SceneCache<NumericT>& cache,
+    const internal::SceneCache<NumericT>& cache,
+    Target& target,
     int rx0, int ry0, int rx1, int ry1)
 {
-    auto& renderer = cache.renderer;
-    auto& zBuffer  = cache.zBuffer;
-
     const auto& v0 = tri[0].pixel;
     const auto& v1 = tri[1].pixel;
     const auto& v2 = tri[2].pixel;
@@ -153,7 +400,8 @@ void rasterizeTriangleInRect(
                     w2 * tri[2].invW;
                 const NumericT z = NumericT(1) / baryInvW;
 
-                if (z > 0 && z < zBuffer[y][x])
+                NumericT& depth = target.depth(x, y);
+                if (z > 0 && z < depth)
                 {
                     auto attr = (a0 * w0 + a1 * w1 + a2 * w2) * z;
 
@@ -168,8 +416,8 @@ void rasterizeTriangleInRect(
                         cache.lights
                     };
 
-                    zBuffer[y][x] = z;
-                    renderer.setPixel(x, y, shader(frag));
+                    depth = z;
+                    target.write(x, y, shader(frag));
                 }
             }
             else if (entered)
@@ -188,105 +436,252 @@ void rasterizeTriangleInRect(
     }
 }
 
+template<typename NumericT, typename FragmentShader>
+void rasterizeTriangleInRect(
+    const std::array<internal::ProjectedVertex<NumericT>, 3>& tri,
+    const FragmentShader& shader,
+    internal::SceneCache<NumericT>& cache,
+    int rx0, int ry0, int rx1, int ry1)
+{
+    SceneTarget<NumericT> target{cache.renderer, cache.zBuffer};
+    rasterizeTriangleInRect(tri, shader, cache, target, rx0, ry0, rx1, ry1);
+}
+
 
 
+/// Working storage of rasterizeTiledWith(). Kept by the caller across
+/// frames, so binning a scene of steady size stops allocating.
+template<typename NumericT>
+struct TileBins
+{
+    struct TileRange { int tx0, ty0, tx1, ty1; };
+
+    std::vector<TileRange> ranges;
+    std::vector<int> counts;
+    std::vector<int> offset;
+    std::vector<std::size_t> indices;
+    std::vector<int> order;
+    std::vector<BufferedTileTarget<NumericT>> targets;
+    std::vector<TileHiZ<NumericT>> hiZ;
+};
+
 /// Bin projected triangles into screen-space tiles then rasterize
 /// each tile. Processing one tile at a time keeps z-buffer and
 /// framebuffer data in L1 cache.
-template<typename NumericT, typename FragmentShader>
-void rasterizeTiled(
+///
+/// With cache.pool set the tiles run in parallel, most triangles first:
+/// every thread takes the costliest tile left, so a crowded tile starts
+/// early instead of finishing last. Each thread shades into its own
+/// BufferedTileTarget and flushes the colors when the tile is done. A pixel still sees its
+/// triangles in submission order, so the frame equals the serial one;
+/// the shader is called concurrently and must not mutate shared state.
+///
+/// Each tile keeps a TileHiZ, which drops triangles lying behind
+/// everything drawn there so far.
+///
+/// shaderOf(i) returns the fragment shader of triangle i; see the
+/// overloads below for one shader per call or per triangle id. @p bins
+/// holds the binning buffers between calls; null uses temporary ones.
+template<typename NumericT, typename ShaderOf>
+void rasterizeTiledWith(
     const std::vector<std::array<internal::ProjectedVertex<NumericT>, 3>>& triangles,
-    const FragmentShader& shader,
-    internal::SceneCache<NumericT>& cache)
+    ShaderOf&& shaderOf,
+    internal::SceneCache<NumericT>& cache,
+    TileBins<NumericT>* bins = nullptr)
 {
     if (triangles.empty())
         return;
 
+    TileBins<NumericT> localBins;
+    TileBins<NumericT>& b = bins ? *bins : localBins;
+
     const int W = static_cast<int>(cache.renderer.getRenderWidth());
     const int H = static_cast<int>(cache.renderer.getRenderHeight());
     const int tilesX = (W + TILE_SIZE - 1) / TILE_SIZE;
     const int tilesY = (H + TILE_SIZE - 1) / TILE_SIZE;
     const int nTiles = tilesX * tilesY;
 
-    // ---- Pass 1: compute bounding-box tile ranges & count per tile ----
-
-    struct TileRange { int tx0, ty0, tx1, ty1; };
-    std::vector<TileRange> ranges(triangles.size());
-    std::vector<int> count(nTiles, 0);
+    auto& offset = b.offset;
+    auto& indices = b.indices;
+    offset.assign(static_cast<std::size_t>(nTiles) + 1, 0);
 
-    for (std::size_t i = 0; i < triangles.size(); ++i)
     {
-        const auto& tri = triangles[i];
-        const auto& p0 = tri[0].pixel;
-        const auto& p1 = tri[1].pixel;
-        const auto& p2 = tri[2].pixel;
+        SC_PROFILE_STAGE(Binning);
 
-        int bx0 = std::max(0,     static_cast<int>(std::min({p0[0], p1[0], p2[0]})));
-        int bx1 = std::min(W - 1, static_cast<int>(std::max({p0[0], p1[0], p2[0]})));
-        int by0 = std::max(0,     static_cast<int>(std::min({p0[1], p1[1], p2[1]})));
-        int by1 = std::min(H - 1, static_cast<int>(std::max({p0[1], p1[1], p2[1]})));
+        // Triangles are binned in chunks, each with its own tile counts.
+        // A tile's slots are laid out chunk after chunk, so every tile
+        // lists its triangles in submission order for any chunking.
 
-        if (bx0 > bx1 || by0 > by1)
+        // ---- Pass 1: compute bounding-box tile ranges & count per tile ----
+
+        auto& ranges = b.ranges;
+        auto& counts = b.counts;
+        ranges.resize(triangles.size());
+        const std::size_t chunks = internal::chunkCount(cache.pool, triangles.size());
+        counts.assign(chunks * static_cast<std::size_t>(nTiles), 0);
+
+        internal::forEachChunk(cache.pool, triangles.size(),
+            [&](std::size_t chunk, std::size_t begin, std::size_t end)
         {
-            ranges[i] = {0, 0, -1, -1};  // empty sentinel
-            continue;
-        }
+            int* count = &counts[chunk * static_cast<std::size_t>(nTiles)];
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const auto& tri = triangles[i];
+                const auto& p0 = tri[0].pixel;
+                const auto& p1 = tri[1].pixel;
+                const auto& p2 = tri[2].pixel;
 
-        const int tx0 = bx0 / TILE_SIZE;
-        const int tx1 = std::min(bx1 / TILE_SIZE, tilesX - 1);
-        const int ty0 = by0 / TILE_SIZE;
-        const int ty1 = std::min(by1 / TILE_SIZE, tilesY - 1);
-        ranges[i] = {tx0, ty0, tx1, ty1};
+                int bx0 = std::max(0,     static_cast<int>(std::min({p0[0], p1[0], p2[0]})));
+                int bx1 = std::min(W - 1, static_cast<int>(std::max({p0[0], p1[0], p2[0]})));
+                int by0 = std::max(0,     static_cast<int>(std::min({p0[1], p1[1], p2[1]})));
+                int by1 = std::min(H - 1, static_cast<int>(std::max({p0[1], p1[1], p2[1]})));
 
-        for (int ty = ty0; ty <= ty1; ++ty)
-            for (int tx = tx0; tx <= tx1; ++tx)
-                ++count[ty * tilesX + tx];
-    }
+                if (bx0 > bx1 || by0 > by1)
+                {
+                    ranges[i] = {0, 0, -1, -1};  // empty sentinel
+                    continue;
+                }
 
-    std::vector<int> offset(nTiles + 1, 0);
-    for (int t = 0; t < nTiles; ++t)
-        offset[t + 1] = offset[t] + count[t];
+                const int tx0 = bx0 / TILE_SIZE;
+                const int tx1 = std::min(bx1 / TILE_SIZE, tilesX - 1);
+                const int ty0 = by0 / TILE_SIZE;
+                const int ty1 = std::min(by1 / TILE_SIZE, tilesY - 1);
+                ranges[i] = {tx0, ty0, tx1, ty1};
 
-    std::vector<std::size_t> indices(static_cast<std::size_t>(offset[nTiles]));
-    std::fill(count.begin(), count.end(), 0);   // reuse as write cursors
+                for (int ty = ty0; ty <= ty1; ++ty)
+                    for (int tx = tx0; tx <= tx1; ++tx)
+                        ++count[ty * tilesX + tx];
+            }
+        });
 
-    for (std::size_t i = 0; i < triangles.size(); ++i)
-    {
-        const auto& r = ranges[i];
-        if (r.tx0 > r.tx1)
-            continue;
+        // ---- Prefix sum: tile offsets, counts become per-chunk cursors ----
 
-        for (int ty = r.ty0; ty <= r.ty1; ++ty)
+        int total = 0;
+        for (int t = 0; t < nTiles; ++t)
         {
-            for (int tx = r.tx0; tx <= r.tx1; ++tx)
+            offset[t] = total;
+            for (std::size_t c = 0; c < chunks; ++c)
             {
-                const int tile = ty * tilesX + tx;
-                indices[static_cast<std::size_t>(offset[tile] + count[tile])] = i;
-                ++count[tile];
+                int& count = counts[c * static_cast<std::size_t>(nTiles) + static_cast<std::size_t>(t)];
+                const int n = count;
+                count = total;
+                total += n;
             }
         }
+        offset[nTiles] = total;
+
+        // ---- Pass 2: scatter triangle indices ----
+
+        indices.resize(static_cast<std::size_t>(total));
+        internal::forEachChunk(cache.pool, triangles.size(),
+            [&](std::size_t chunk, std::size_t begin, std::size_t end)
+        {
+            int* cursor = &counts[chunk * static_cast<std::size_t>(nTiles)];
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const auto& r = ranges[i];
+                if (r.tx0 > r.tx1)
+                    continue;
+
+                for (int ty = r.ty0; ty <= r.ty1; ++ty)
+                    for (int tx = r.tx0; tx <= r.tx1; ++tx)
+                        indices[static_cast<std::size_t>(cursor[ty * tilesX + tx]++)] = i;
+            }
+        });
     }
 
-    for (int ty = 0; ty < tilesY; ++ty)
+    SC_PROFILE_STAGE(Rasterize);
+
+    const auto tileRect = [&](int tile) {
+        const int x0 = (tile % tilesX) * TILE_SIZE;
+        const int y0 = (tile / tilesX) * TILE_SIZE;
+        return std::array{x0, y0, std::min(x0 + TILE_SIZE, W), std::min(y0 + TILE_SIZE, H)};
+    };
+    // Hands the depth block of @p tile to @p target and @p hiZ, then
+    // rasterizes the tile's triangles through the hierarchical depth test.
+    const auto rasterizeTile = [&](auto& target, TileHiZ<NumericT>& hiZ, int tile)
     {
-        for (int tx = 0; tx < tilesX; ++tx)
+        const auto tx = static_cast<std::size_t>(tile % tilesX);
+        const auto ty = static_cast<std::size_t>(tile / tilesX);
+        const bool cleared = cache.zBuffer.stale(tx, ty);
+        NumericT* depths = cache.zBuffer.tile(tx, ty);
+        const auto [x0, y0, x1, y1] = tileRect(tile);
+        target.begin(depths, x0, y0, x1, y1);
+        hiZ.begin(depths, cleared);
+
+        for (int j = offset[tile]; j < offset[tile + 1]; ++j)
         {
-            const int tile = ty * tilesX + tx;
-            const int begin = offset[tile];
-            const int end   = offset[tile + 1];
-            if (begin == end)
-                continue;
-
-            const int x0 = tx * TILE_SIZE;
-            const int y0 = ty * TILE_SIZE;
-            const int x1 = std::min(x0 + TILE_SIZE, W);
-            const int y1 = std::min(y0 + TILE_SIZE, H);
-
-            for (int j = begin; j < end; ++j)
-                rasterizeTriangleInRect(triangles[indices[j]], shader, cache,
-                                        x0, y0, x1, y1);
+            const auto& tri = triangles[indices[j]];
+            const auto& shader = shaderOf(indices[j]);
+            hiZ.rasterize(tri, x0, y0, x1, y1, [&](int rx0, int ry0, int rx1, int ry1) {
+                rasterizeTriangleInRect(tri, shader, cache, target, rx0, ry0, rx1, ry1);
+            });
         }
+    };
+
+    if (!cache.pool || cache.pool->size() == 1)
+    {
+        TileTarget<NumericT> target{cache.renderer};
+        TileHiZ<NumericT> hiZ;
+        for (int tile = 0; tile < nTiles; ++tile)
+        {
+            if (offset[tile] != offset[tile + 1])
+                rasterizeTile(target, hiZ, tile);
+        }
+        return;
     }
+
+    // non-empty tiles, costliest first; ties keep row-major order
+    auto& order = b.order;
+    order.resize(static_cast<std::size_t>(nTiles));
+    std::iota(order.begin(), order.end(), 0);
+    order.erase(std::remove_if(order.begin(), order.end(),
+        [&offset](int t) { return offset[t] == offset[t + 1]; }), order.end());
+    std::stable_sort(order.begin(), order.end(), [&offset](int a, int b) {
+        return offset[a + 1] - offset[a] > offset[b + 1] - offset[b];
+    });
+
+    auto& pool = *cache.pool;
+    auto& scratch = b.targets;
+    auto& hiZ = b.hiZ;
+    scratch.resize(pool.size());
+    hiZ.resize(pool.size());
+    std::atomic<std::size_t> next{0};
+
+    pool.parallelFor(std::min(pool.size(), order.size()), [&](std::size_t, std::size_t slot)
+    {
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < order.size();
+             i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            rasterizeTile(scratch[slot], hiZ[slot], order[i]);
+            scratch[slot].store(cache.renderer);
+        }
+    });
+}
+
+/// rasterizeTiledWith() shading every triangle with @p shader.
+template<typename NumericT, typename FragmentShader>
+void rasterizeTiled(
+    const std::vector<std::array<internal::ProjectedVertex<NumericT>, 3>>& triangles,
+    const FragmentShader& shader,
+    internal::SceneCache<NumericT>& cache)
+{
+    rasterizeTiledWith(triangles, [&shader](std::size_t) -> const FragmentShader& { return shader; }, cache);
+}
+
+/// rasterizeTiledWith() shading triangle i with shaders[shaderIds[i]], so
+/// triangles of many models are binned and rasterized in one pass.
+template<typename NumericT, typename FragmentShader>
+void rasterizeTiled(
+    const std::vector<std::array<internal::ProjectedVertex<NumericT>, 3>>& triangles,
+    const std::vector<std::uint32_t>& shaderIds,
+    const std::vector<FragmentShader>& shaders,
+    internal::SceneCache<NumericT>& cache,
+    TileBins<NumericT>* bins = nullptr)
+{
+    rasterizeTiledWith(triangles,
+        [&shaderIds, &shaders](std::size_t i) -> const FragmentShader& { return shaders[shaderIds[i]]; },
+        cache, bins);
 }
 
 } // namespace mrc::gt
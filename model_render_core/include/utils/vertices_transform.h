@@ -1,39 +1,44 @@
 #pragma once
 #include <vector>
 
+#include "parallel_chunks.h"
 #include "utils/vec.h"
 
 namespace mrc::internal
 {
 
+/// Writes the transformed verticies into @p ret, reusing its capacity.
+/// Chunks run on @p pool when set.
 template <typename NumericT>
-std::vector<sc::utils::Vec<NumericT, 3>> transformVerticies(
+void transformVerticies(
     const std::vector<sc::utils::Vec<NumericT, 3>>& verticies,
     const sc::utils::Vec<NumericT, 3>& pos,
-    const sc::utils::Vec<NumericT, 3>& rot)
+    const sc::utils::Vec<NumericT, 3>& rot,
+    std::vector<sc::utils::Vec<NumericT, 3>>& ret,
+    sc::utils::ThreadPool* pool = nullptr)
 {
-    std::vector<sc::utils::Vec<NumericT, 3>> ret;
-    ret.reserve(verticies.size());
-    for (const auto& v : verticies)
+    ret.resize(verticies.size());
+    forEachChunk(pool, verticies.size(), [&](std::size_t, std::size_t begin, std::size_t end)
     {
-        ret.emplace_back(rotateEuler(v, rot) + pos);
-    }
-    return ret;
+        for (std::size_t i = begin; i < end; ++i)
+            ret[i] = rotateEuler(verticies[i], rot) + pos;
+    });
 }
 
-/// Transform normals by rotation only (no translation).
+/// Transform normals by rotation only (no translation), into @p ret.
 template <typename NumericT>
-std::vector<sc::utils::Vec<NumericT, 3>> transformNormals(
+void transformNormals(
     const std::vector<sc::utils::Vec<NumericT, 3>>& normals,
-    const sc::utils::Vec<NumericT, 3>& rot)
+    const sc::utils::Vec<NumericT, 3>& rot,
+    std::vector<sc::utils::Vec<NumericT, 3>>& ret,
+    sc::utils::ThreadPool* pool = nullptr)
 {
-    std::vector<sc::utils::Vec<NumericT, 3>> ret;
-    ret.reserve(normals.size());
-    for (const auto& n : normals)
+    ret.resize(normals.size());
+    forEachChunk(pool, normals.size(), [&](std::size_t, std::size_t begin, std::size_t end)
     {
-        ret.emplace_back(rotateEuler(n, rot));
-    }
-    return ret;
+        for (std::size_t i = begin; i < end; ++i)
+            ret[i] = rotateEuler(normals[i], rot);
+    });
 }
 
 } // namespace mrc::internal